@@ -0,0 +1,119 @@
+#include "FeedProtocol.h"
+
+#include <QtEndian>
+
+// 帧头: [操作类型:1] [起始位置:4] [行数:4]
+static const int FrameHeader = 9;
+
+/**
+* @brief 将一批数据编码为一帧, 追加到 out 末尾
+* @param out 输出缓冲
+* @param operation 操作类型
+* @param rows 行数据
+* @param index 起始位置, 用于修改操作
+*/
+void FeedProtocol::encode(QByteArray &out, int operation, const QList<QStringList> &rows, int index) {
+    int start = out.size();
+    out.resize(start + 4 + FrameHeader);
+    char *header = out.data() + start;
+    header[4] = char(operation);
+    qToLittleEndian<qint32>(index, header + 5);
+    qToLittleEndian<quint32>(quint32(rows.size()), header + 9);
+
+    char buffer[4];
+    for (const QStringList &row : rows) {
+        int cells = qMin(row.size(), 0xFFFF);
+        qToLittleEndian<quint16>(quint16(cells), buffer);
+        out.append(buffer, 2);
+        for (int c = 0; c < cells; c++) {
+            const QByteArray utf8 = row.at(c).toUtf8();
+            qToLittleEndian<quint32>(quint32(utf8.size()), buffer);
+            out.append(buffer, 4);
+            out.append(utf8);
+        }
+    }
+    qToLittleEndian<quint32>(quint32(out.size() - start - 4), out.data() + start);
+}
+
+/**
+* @brief 从缓冲区头部解析所有完整的帧, 已解析的字节从缓冲区移除, 不完整的帧留待下次
+* @param buffer 接收缓冲
+* @param batches 解析出的批次追加到此
+* @param error 出错时的错误信息
+* @return 是否成功; 失败表示数据流已损坏, 应断开连接
+*
+* 单元格直接从接收缓冲解码为字符串, 不另行复制帧字节; 写入存储时 applyUpdate 仍会把字符串
+* 重新编码为记录, 即每个单元格各经历一次 UTF-8 解码和一次记录编码。
+*/
+bool FeedProtocol::decode(QByteArray &buffer, QList<Batch> &batches, QString *error) {
+    const char *data = buffer.constData();
+    int pos = 0;
+    bool ok = true;
+    QString message;
+
+    while (buffer.size() - pos >= 4) {
+        quint32 length = qFromLittleEndian<quint32>(data + pos);
+        if (length < quint32(FrameHeader) || length > quint32(MaxFrameSize)) {
+            message = QString::fromUtf8("帧长度无效: %1").arg(length);
+            ok = false;
+            break;
+        }
+        if (quint32(buffer.size() - pos - 4) < length) {
+            break; // 帧不完整, 等待更多数据
+        }
+
+        const char *p = data + pos + 4;
+        const char *end = p + length;
+        Batch batch;
+        batch.operation = quint8(p[0]);
+        batch.index = qFromLittleEndian<qint32>(p + 1);
+        quint32 rowCount = qFromLittleEndian<quint32>(p + 5);
+        p += FrameHeader;
+        if (batch.operation > 2 || rowCount > length / 2) {
+            message = QString::fromUtf8("帧头无效: 操作类型 %1, 行数 %2").arg(batch.operation).arg(rowCount);
+            ok = false;
+            break;
+        }
+
+        batch.rows.reserve(int(rowCount));
+        for (quint32 r = 0; ok && r < rowCount; r++) {
+            if (end - p < 2) {
+                ok = false;
+                break;
+            }
+            int cells = qFromLittleEndian<quint16>(p);
+            p += 2;
+            QStringList row;
+            row.reserve(cells);
+            for (int c = 0; c < cells; c++) {
+                if (end - p < 4) {
+                    ok = false;
+                    break;
+                }
+                quint32 bytes = qFromLittleEndian<quint32>(p);
+                p += 4;
+                if (quint32(end - p) < bytes) {
+                    ok = false;
+                    break;
+                }
+                row << QString::fromUtf8(p, int(bytes));
+                p += bytes;
+            }
+            batch.rows.append(row);
+        }
+        if (!ok || p != end) {
+            message = QString::fromUtf8("帧内容与长度不符");
+            ok = false;
+            break;
+        }
+
+        batches.append(batch);
+        pos += 4 + int(length);
+    }
+
+    buffer.remove(0, pos);
+    if (!ok && error) {
+        *error = message;
+    }
+    return ok;
+}
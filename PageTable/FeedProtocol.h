@@ -0,0 +1,56 @@
+#ifndef FEEDPROTOCOL_H
+#define FEEDPROTOCOL_H
+
+#include <QMetaType>
+#include <QByteArray>
+#include <QStringList>
+
+/**
+ * @author : LMH
+ * @date   : 2026.10.18
+ * @brief  : 分页组件数据流的二进制帧格式, 供本地套接字接入、导出和生产者工具共用
+ *
+ * 帧格式(小端):
+ *   [帧长度:4] [操作类型:1] [起始位置:4] [行数:4]
+ *   每行:     [单元格数:2]
+ *   每个单元格: [UTF-8 字节数:4] [UTF-8 字节]
+ * 帧长度不包括自身的 4 个字节; 操作类型取值同 PageTable::Operation (0 追加, 1 修改, 2 删除)。
+ */
+class FeedProtocol {
+
+public:
+    /**
+     * @brief 一帧解析出的数据批次
+     */
+    struct Batch {
+        int operation = 0;
+        int index = -1;
+        QList<QStringList> rows;
+    };
+
+    /**
+     * @brief 单帧最大字节数, 超出视为数据错误
+     */
+    static constexpr int MaxFrameSize = 64 * 1024 * 1024;
+
+    /**
+     * @brief 将一批数据编码为一帧, 追加到 out 末尾
+     * @param out 输出缓冲
+     * @param operation 操作类型
+     * @param rows 行数据
+     * @param index 起始位置, 用于修改操作
+     */
+    static void encode(QByteArray &out, int operation, const QList<QStringList> &rows, int index = -1);
+    /**
+     * @brief 从缓冲区头部解析所有完整的帧, 已解析的字节从缓冲区移除, 不完整的帧留待下次
+     * @param buffer 接收缓冲
+     * @param batches 解析出的批次追加到此
+     * @param error 出错时的错误信息
+     * @return 是否成功; 失败表示数据流已损坏, 应断开连接
+     */
+    static bool decode(QByteArray &buffer, QList<Batch> &batches, QString *error = nullptr);
+};
+
+Q_DECLARE_METATYPE(FeedProtocol::Batch)
+
+#endif // FEEDPROTOCOL_H
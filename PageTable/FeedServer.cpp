@@ -0,0 +1,122 @@
+#include "FeedServer.h"
+
+FeedServer::FeedServer(QObject *parent) : QObject(parent), m_Server(nullptr), m_InFlight(0) {
+}
+
+/**
+* @brief 开始监听
+* @param name 本地服务名
+* @return 是否监听成功; 名称已被其他正在运行的服务占用时返回 false
+*/
+bool FeedServer::start(const QString &name) {
+    stop();
+    // 能连上说明名称仍在使用, 不能删除其套接字文件; 连不上才是上次异常退出遗留的文件, 清理后再监听
+    QLocalSocket probe;
+    probe.connectToServer(name);
+    if (probe.waitForConnected(100)) {
+        probe.abort();
+        return false;
+    }
+    QLocalServer::removeServer(name);
+
+    m_Server = new QLocalServer(this);
+    connect(m_Server, &QLocalServer::newConnection, this, &FeedServer::acceptConnection);
+    return m_Server->listen(name);
+}
+/**
+* @brief 停止监听并断开所有连接
+*/
+void FeedServer::stop() {
+    const QList<QLocalSocket*> sockets = m_Buffers.keys();
+    for (QLocalSocket *socket : sockets) {
+        socket->abort();
+        socket->deleteLater();
+    }
+    m_Buffers.clear();
+    if (m_Server) {
+        m_Server->close();
+        m_Server->deleteLater();
+        m_Server = nullptr;
+    }
+}
+/**
+* @brief 分页组件写入一个批次后调用, 在途批次低于上限时恢复读取
+*/
+void FeedServer::batchApplied() {
+    // stop 之前发出的批次仍会陆续回报, 计数不低于 0
+    if (m_InFlight > 0) {
+        m_InFlight--;
+    }
+    const QList<QLocalSocket*> sockets = m_Buffers.keys();
+    for (QLocalSocket *socket : sockets) {
+        if (m_InFlight >= MaxInFlight) {
+            break;
+        }
+        if (m_Buffers.contains(socket) && socket->bytesAvailable() > 0) {
+            readFrom(socket);
+        }
+    }
+}
+
+/**
+* @brief 接受新的连接
+*/
+void FeedServer::acceptConnection() {
+    while (m_Server && m_Server->hasPendingConnections()) {
+        QLocalSocket *socket = m_Server->nextPendingConnection();
+        m_Buffers.insert(socket, QByteArray());
+        // 暂停读取时套接字只缓存有限的数据, 其余留在系统缓冲中, 让生产者感知到拥塞
+        socket->setReadBufferSize(ReadBufferSize);
+        connect(socket, &QLocalSocket::readyRead, this, &FeedServer::readSocket);
+        connect(socket, &QLocalSocket::disconnected, this, [this, socket]() {
+            // 暂停期间断开的连接保留到缓存的数据读完, 由 readFrom 释放
+            if (socket->bytesAvailable() > 0 && m_Buffers.contains(socket)) {
+                return;
+            }
+            m_Buffers.remove(socket);
+            socket->deleteLater();
+        });
+    }
+}
+/**
+* @brief 读取连接上的数据并解析完整的帧
+*/
+void FeedServer::readSocket() {
+    QLocalSocket *socket = qobject_cast<QLocalSocket*>(sender());
+    if (!socket || !m_Buffers.contains(socket)) {
+        return;
+    }
+    readFrom(socket);
+}
+/**
+* @brief 读取指定连接上的数据并解析完整的帧, 在途批次达到上限时不读取
+* @param socket 连接
+*
+* 一次读取最多 ReadBufferSize 字节, 其中的帧全部发出, 因此在途批次最多超出上限一次读取所含的帧数。
+*/
+void FeedServer::readFrom(QLocalSocket *socket) {
+    if (m_InFlight >= MaxInFlight) {
+        return; // 暂停读取, 等待 batchApplied 恢复
+    }
+
+    QByteArray &buffer = m_Buffers[socket];
+    buffer.append(socket->readAll());
+
+    QList<FeedProtocol::Batch> batches;
+    QString error;
+    bool ok = FeedProtocol::decode(buffer, batches, &error);
+    m_InFlight += batches.size();
+    for (const FeedProtocol::Batch &batch : qAsConst(batches)) {
+        emit batchReceived(batch);
+    }
+    if (!ok) {
+        emit clientError(error);
+        m_Buffers.remove(socket);
+        socket->abort();
+        socket->deleteLater();
+    } else if (socket->state() == QLocalSocket::UnconnectedState && socket->bytesAvailable() == 0) {
+        // 已断开的连接数据读完后释放
+        m_Buffers.remove(socket);
+        socket->deleteLater();
+    }
+}
@@ -0,0 +1,93 @@
+#ifndef FEEDSERVER_H
+#define FEEDSERVER_H
+
+#include <QHash>
+#include <QObject>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include "FeedProtocol.h"
+
+/**
+ * @author : LMH
+ * @date   : 2026.10.18
+ * @brief  : 本地套接字数据接入服务, 运行在独立线程, 接收并解析生产者进程发送的数据帧
+ *
+ * 服务对象应移动到工作线程后再调用 start; 解析出的批次通过 batchReceived 信号
+ * 排队发送到分页组件所在线程写入, 写入后应调用 batchApplied。
+ * 未写入的批次达到 MaxInFlight 时暂停读取, 数据留在套接字和系统缓冲中, 生产者写满后随之阻塞。
+ */
+class FeedServer : public QObject {
+    Q_OBJECT
+
+public:
+    explicit FeedServer(QObject *parent = nullptr);
+
+    /**
+     * @brief 已发出但尚未写入的批次上限, 达到后暂停读取
+     */
+    static constexpr int MaxInFlight = 4;
+    /**
+     * @brief 每个连接的读缓冲上限, 暂停期间套接字最多缓存这么多字节
+     */
+    static constexpr qint64 ReadBufferSize = 1 << 20;
+
+public slots:
+    /**
+     * @brief 开始监听
+     * @param name 本地服务名
+     * @return 是否监听成功
+     */
+    bool start(const QString &name);
+    /**
+     * @brief 停止监听并断开所有连接
+     */
+    void stop();
+    /**
+     * @brief 分页组件写入一个批次后调用, 在途批次低于上限时恢复读取
+     */
+    void batchApplied();
+
+signals:
+    /**
+     * @brief 解析出一个数据批次时发射此信号
+     * @param batch 数据批次
+     */
+    void batchReceived(const FeedProtocol::Batch &batch);
+    /**
+     * @brief 连接的数据流损坏时发射此信号, 该连接随后被断开
+     * @param message 错误信息
+     */
+    void clientError(const QString &message);
+
+private slots:
+    /**
+     * @brief 接受新的连接
+     */
+    void acceptConnection();
+    /**
+     * @brief 读取连接上的数据并解析完整的帧
+     */
+    void readSocket();
+
+private:
+    /**
+     * @brief 读取指定连接上的数据并解析完整的帧, 在途批次达到上限时不读取
+     * @param socket 连接
+     */
+    void readFrom(QLocalSocket *socket);
+
+    /**
+     * @brief 本地服务
+     */
+    QLocalServer* m_Server;
+    /**
+     * @brief 每个连接未解析完的数据
+     */
+    QHash<QLocalSocket*, QByteArray> m_Buffers;
+    /**
+     * @brief 已发出但尚未写入的批次数
+     */
+    int m_InFlight;
+};
+
+#endif // FEEDSERVER_H
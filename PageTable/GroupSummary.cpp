@@ -0,0 +1,234 @@
+#include "GroupSummary.h"
+
+#include <QtMath>
+#include <algorithm>
+#include <iterator>
+
+GroupSummary::GroupSummary(int groupColumn, Aggregate aggregate, int valueColumn, int pivotColumn)
+    : m_GroupColumn(groupColumn), m_Aggregate(aggregate), m_ValueColumn(valueColumn), m_PivotColumn(pivotColumn),
+      m_KeysDirty(false), m_DeferRemoval(false) {
+}
+
+/**
+* @brief 计入或扣除一行
+* @param row 行数据
+* @param sign 1 表示计入, -1 表示扣除
+*/
+void GroupSummary::add(const QStringList &row, int sign) {
+    Cell delta;
+    delta.rows = sign;
+    if (m_Aggregate != Count) {
+        bool ok = false;
+        double value = row.value(m_ValueColumn).toDouble(&ok);
+        if (ok && !qIsNaN(value)) {
+            delta.numeric = sign;
+            delta.sum = sign * value;
+        }
+    }
+
+    const QString key = row.value(m_GroupColumn);
+    auto group = m_Groups.find(key);
+    if (group == m_Groups.end()) {
+        group = m_Groups.insert(key, Group());
+        m_KeysDirty = true;
+    }
+    if (m_PivotColumn >= 0) {
+        const QString pivot = row.value(m_PivotColumn);
+        if (accumulate(group->pivots[pivot], delta) && !m_DeferRemoval) {
+            group->pivots.remove(pivot);
+        }
+        qint64 &pivotRows = m_PivotKeys[pivot];
+        pivotRows += sign;
+        if (pivotRows == 0) {
+            m_PivotKeys.remove(pivot);
+        }
+    }
+    if (accumulate(group->total, delta) && !m_DeferRemoval) {
+        m_Groups.erase(group);
+        m_KeysDirty = true;
+    }
+}
+/**
+* @brief 合并另一份配置相同的汇总
+*/
+void GroupSummary::merge(const GroupSummary &other) {
+    for (auto it = other.m_Groups.constBegin(); it != other.m_Groups.constEnd(); ++it) {
+        auto group = m_Groups.find(it.key());
+        if (group == m_Groups.end()) {
+            group = m_Groups.insert(it.key(), Group());
+            m_KeysDirty = true;
+        }
+        for (auto pivot = it->pivots.constBegin(); pivot != it->pivots.constEnd(); ++pivot) {
+            if (accumulate(group->pivots[pivot.key()], pivot.value()) && !m_DeferRemoval) {
+                group->pivots.remove(pivot.key());
+            }
+        }
+        if (accumulate(group->total, it->total) && !m_DeferRemoval) {
+            m_Groups.erase(group);
+            m_KeysDirty = true;
+        }
+    }
+    for (auto it = other.m_PivotKeys.constBegin(); it != other.m_PivotKeys.constEnd(); ++it) {
+        qint64 &pivotRows = m_PivotKeys[it.key()];
+        pivotRows += it.value();
+        if (pivotRows == 0) {
+            m_PivotKeys.remove(it.key());
+        }
+    }
+}
+/**
+* @brief 清空统计结果, 保留配置
+*/
+void GroupSummary::clear() {
+    m_Groups.clear();
+    m_PivotKeys.clear();
+    m_SortedKeys.clear();
+    m_KeysDirty = false;
+    m_DeferRemoval = false;
+}
+/**
+* @brief 设置是否暂缓移除行数归零的分组
+* @param defer 是否暂缓
+*/
+void GroupSummary::setDeferRemoval(bool defer) {
+    m_DeferRemoval = defer;
+    if (defer) {
+        return;
+    }
+    for (auto group = m_Groups.begin(); group != m_Groups.end();) {
+        for (auto pivot = group->pivots.begin(); pivot != group->pivots.end();) {
+            pivot = pivot->rows == 0 ? group->pivots.erase(pivot) : std::next(pivot);
+        }
+        if (group->total.rows == 0) {
+            group = m_Groups.erase(group);
+            m_KeysDirty = true;
+        } else {
+            ++group;
+        }
+    }
+}
+/**
+* @brief 分组数量
+*/
+int GroupSummary::groupCount() const {
+    return m_Groups.size();
+}
+/**
+* @brief 汇总表的表头
+* @param sourceHeader 原始数据的表头, 用于命名分组列和汇总列
+*/
+QStringList GroupSummary::header(const QStringList &sourceHeader) const {
+    QStringList header;
+    header << sourceHeader.value(m_GroupColumn, QString::fromUtf8("分组"));
+    if (m_PivotColumn >= 0) {
+        header << m_PivotKeys.keys();
+        header << QString::fromUtf8("合计");
+        return header;
+    }
+    const QString valueName = sourceHeader.value(m_ValueColumn);
+    switch (m_Aggregate) {
+    case Count: header << QString::fromUtf8("行数"); break;
+    case Sum: header << QString::fromUtf8("行数") << QString::fromUtf8("合计(%1)").arg(valueName); break;
+    case Average: header << QString::fromUtf8("行数") << QString::fromUtf8("平均(%1)").arg(valueName); break;
+    }
+    return header;
+}
+/**
+* @brief 按分组取值排序后, 获取指定区间的汇总行
+* @param first 起始分组
+* @param count 分组数量
+* @return 汇总行: 分组取值, 随后为汇总结果(透视时每个透视取值一列, 最后一列为合计)
+*/
+QList<QStringList> GroupSummary::rows(int first, int count) const {
+    sortKeys();
+
+    QList<QStringList> result;
+    int end = qMin(first + count, m_SortedKeys.size());
+    for (int i = qMax(0, first); i < end; i++) {
+        const QString &key = m_SortedKeys.at(i);
+        const Group &group = m_Groups.find(key).value();
+        QStringList row;
+        row << key;
+        if (m_PivotColumn >= 0) {
+            for (auto pivot = m_PivotKeys.constBegin(); pivot != m_PivotKeys.constEnd(); ++pivot) {
+                auto cell = group.pivots.constFind(pivot.key());
+                row << (cell == group.pivots.constEnd() ? QString() : format(cell.value()));
+            }
+            row << format(group.total);
+        } else {
+            row << QString::number(group.total.rows);
+            if (m_Aggregate != Count) {
+                row << format(group.total);
+            }
+        }
+        result.append(row);
+    }
+    return result;
+}
+
+/**
+* @brief 获取汇总表的单元格, 与 rows 的列顺序相同
+* @param row 分组序号
+* @param column 列索引
+* @return 单元格文本, 越界时为空
+*/
+QString GroupSummary::cell(int row, int column) const {
+    sortKeys();
+    if (row < 0 || row >= m_SortedKeys.size() || column < 0) {
+        return QString();
+    }
+    const QString &key = m_SortedKeys.at(row);
+    if (column == 0) {
+        return key;
+    }
+    const Group &group = m_Groups.find(key).value();
+    if (m_PivotColumn >= 0) {
+        if (column == m_PivotKeys.size() + 1) {
+            return format(group.total);
+        }
+        if (column > m_PivotKeys.size()) {
+            return QString();
+        }
+        auto cell = group.pivots.constFind(std::next(m_PivotKeys.constBegin(), column - 1).key());
+        return cell == group.pivots.constEnd() ? QString() : format(cell.value());
+    }
+    if (column == 1) {
+        return QString::number(group.total.rows);
+    }
+    return column == 2 && m_Aggregate != Count ? format(group.total) : QString();
+}
+
+/**
+* @brief 累加一份汇总量, 行数归零时返回 true, 由调用方移除
+*/
+bool GroupSummary::accumulate(Cell &cell, const Cell &delta) {
+    cell.rows += delta.rows;
+    cell.numeric += delta.numeric;
+    cell.sum += delta.sum;
+    return cell.rows == 0;
+}
+/**
+* @brief 按汇总方式格式化
+*/
+QString GroupSummary::format(const Cell &cell) const {
+    switch (m_Aggregate) {
+    case Count:
+        return QString::number(cell.rows);
+    case Sum:
+        return cell.numeric > 0 ? QString::number(cell.sum, 'g', 15) : QString();
+    case Average:
+        return cell.numeric > 0 ? QString::number(cell.sum / double(cell.numeric), 'g', 15) : QString();
+    }
+    return QString();
+}
+/**
+* @brief 分组增减后重新排序分组取值
+*/
+void GroupSummary::sortKeys() const {
+    if (!m_KeysDirty) {
+        return;
+    }
+    m_SortedKeys = m_Groups.keys();
+    std::sort(m_SortedKeys.begin(), m_SortedKeys.end());
+    m_KeysDirty = false;
+}
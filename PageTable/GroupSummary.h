@@ -0,0 +1,136 @@
+#ifndef GROUPSUMMARY_H
+#define GROUPSUMMARY_H
+
+#include <QMap>
+#include <QHash>
+#include <QStringList>
+
+/**
+ * @author : LMH
+ * @date   : 2026.10.18
+ * @brief  : 分组汇总, 按一列分组统计另一列的行数、合计或平均值, 可再按一列展开为透视表
+ *
+ * 每个分组(及透视单元格)只保存行数、数值个数和数值合计, 这些量都可以直接相加减:
+ * 新增一行加一次, 删除一行减一次, 修改即先减后加; 分片统计的结果也可以直接合并,
+ * 因此可以在多个工作线程上各自统计一段数据, 再与统计期间发生的增量合并, 结果与整体统计一致。
+ */
+class GroupSummary {
+
+public:
+    /**
+     * @brief 汇总方式枚举: 行数、合计、平均值
+     */
+    enum Aggregate {
+        Count = 0,
+        Sum = 1,
+        Average = 2
+    };
+
+    /**
+     * @param groupColumn 分组列
+     * @param aggregate 汇总方式
+     * @param valueColumn 汇总列, 行数汇总时忽略
+     * @param pivotColumn 透视列, 其每个取值展开为一列; 小于 0 表示不透视
+     */
+    explicit GroupSummary(int groupColumn = 0, Aggregate aggregate = Count, int valueColumn = -1, int pivotColumn = -1);
+
+    /**
+     * @brief 计入或扣除一行
+     * @param row 行数据
+     * @param sign 1 表示计入, -1 表示扣除
+     */
+    void add(const QStringList &row, int sign = 1);
+    /**
+     * @brief 合并另一份配置相同的汇总
+     */
+    void merge(const GroupSummary &other);
+    /**
+     * @brief 清空统计结果, 保留配置
+     */
+    void clear();
+    /**
+     * @brief 设置是否暂缓移除行数归零的分组
+     * @param defer 是否暂缓
+     *
+     * 还有分段结果未合并时, 行数归零的分组可能仍带有待抵消的合计(例如先删除了快照中的行),
+     * 此时移除会丢失这部分合计, 须暂缓到全部合并完成; 取消暂缓时一次移除行数为 0 的分组。
+     */
+    void setDeferRemoval(bool defer);
+    /**
+     * @brief 分组数量
+     */
+    int groupCount() const;
+    /**
+     * @brief 汇总表的表头
+     * @param sourceHeader 原始数据的表头, 用于命名分组列和汇总列
+     */
+    QStringList header(const QStringList &sourceHeader) const;
+    /**
+     * @brief 按分组取值排序后, 获取指定区间的汇总行
+     * @param first 起始分组
+     * @param count 分组数量
+     * @return 汇总行: 分组取值, 随后为汇总结果(透视时每个透视取值一列, 最后一列为合计)
+     */
+    QList<QStringList> rows(int first, int count) const;
+    /**
+     * @brief 获取汇总表的单元格, 与 rows 的列顺序相同
+     * @param row 分组序号
+     * @param column 列索引
+     * @return 单元格文本, 越界时为空
+     */
+    QString cell(int row, int column) const;
+
+private:
+    /**
+     * @brief 可加减的汇总量
+     */
+    struct Cell {
+        qint64 rows = 0;
+        qint64 numeric = 0;
+        double sum = 0;
+    };
+    /**
+     * @brief 分组: 合计及各透视取值的汇总
+     */
+    struct Group {
+        Cell total;
+        QHash<QString, Cell> pivots;
+    };
+
+    int m_GroupColumn;
+    Aggregate m_Aggregate;
+    int m_ValueColumn;
+    int m_PivotColumn;
+    /**
+     * @brief 分组取值 -> 分组
+     */
+    QHash<QString, Group> m_Groups;
+    /**
+     * @brief 透视取值 -> 行数, 按取值排序即透视列的顺序
+     */
+    QMap<QString, qint64> m_PivotKeys;
+    /**
+     * @brief 排序后的分组取值, 分组增减时重建
+     */
+    mutable QStringList m_SortedKeys;
+    mutable bool m_KeysDirty;
+    /**
+     * @brief 是否暂缓移除行数归零的分组
+     */
+    bool m_DeferRemoval;
+
+    /**
+     * @brief 累加一份汇总量, 行数归零时返回 true, 由调用方移除
+     */
+    static bool accumulate(Cell &cell, const Cell &delta);
+    /**
+     * @brief 按汇总方式格式化
+     */
+    QString format(const Cell &cell) const;
+    /**
+     * @brief 分组增减后重新排序分组取值
+     */
+    void sortKeys() const;
+};
+
+#endif // GROUPSUMMARY_H
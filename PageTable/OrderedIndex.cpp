@@ -0,0 +1,305 @@
+#include "OrderedIndex.h"
+
+#include <QtMath>
+#include <algorithm>
+
+OrderedIndex::OrderedIndex() : m_Root(-1), m_Seed(0x9E3779B9u) {
+}
+
+/**
+* @brief 元素数量
+*/
+int OrderedIndex::size() const {
+    return sizeOf(m_Root);
+}
+/**
+* @brief 清空
+*/
+void OrderedIndex::clear() {
+    m_Nodes.clear();
+    m_FreeNodes.clear();
+    m_Root = -1;
+}
+/**
+* @brief 插入一行
+* @param value 排序列的取值
+* @param slot 行的槽位号
+*/
+void OrderedIndex::insert(const QString &value, quint32 slot) {
+    // xorshift 生成优先级, 期望树高为 O(log n)
+    m_Seed ^= m_Seed << 13;
+    m_Seed ^= m_Seed >> 17;
+    m_Seed ^= m_Seed << 5;
+
+    Node node;
+    node.key = makeKey(value);
+    node.slot = slot;
+    node.priority = m_Seed;
+    int index = m_Nodes.size();
+    if (!m_FreeNodes.isEmpty()) {
+        index = m_FreeNodes.takeLast();
+        m_Nodes[index] = node;
+    } else {
+        m_Nodes.append(node);
+    }
+
+    int left = -1;
+    int right = -1;
+    split(m_Root, m_Nodes.at(index).key, slot, left, right);
+    m_Root = merge(merge(left, index), right);
+}
+/**
+* @brief 删除一行, 取值和槽位号须与插入时一致
+* @param value 排序列的取值
+* @param slot 行的槽位号
+* @return 是否找到并删除
+*/
+bool OrderedIndex::remove(const QString &value, quint32 slot) {
+    const Key key = makeKey(value);
+    int left = -1;
+    int middle = -1;
+    int right = -1;
+    // 拆出 [(key, slot), (key, slot + 1)) 区间, 其中至多一个节点
+    split(m_Root, key, slot, left, right);
+    split(right, key, slot + 1, middle, right);
+    if (middle >= 0) {
+        m_Nodes[middle] = Node();
+        m_FreeNodes.append(middle);
+    }
+    m_Root = merge(left, right);
+    return middle >= 0;
+}
+/**
+* @brief 按名次取连续的行
+* @param first 起始名次, 从 0 开始
+* @param count 数量
+* @param descending 是否按降序计算名次
+* @return 槽位号, 按名次排列
+*/
+QVector<quint32> OrderedIndex::range(int first, int count, bool descending) const {
+    QVector<quint32> result;
+    int total = size();
+    first = qMax(0, first);
+    count = qMin(count, total - first);
+    if (count <= 0) {
+        return result;
+    }
+    // 降序的名次区间换算为升序区间, 取出后倒序
+    QVector<int> picked = nodes(descending ? total - first - count : first, count);
+    if (descending) {
+        std::reverse(picked.begin(), picked.end());
+        // 倒序后同值的行变成槽位号降序: 区间内部的同值段整段翻转回来;
+        // 首尾两段可能只取到同值区间的一部分, 按区间重新换算名次后取出
+        for (int begin = 0; begin < picked.size();) {
+            const Key &key = m_Nodes.at(picked.at(begin)).key;
+            int end = begin + 1;
+            while (end < picked.size() && compare(m_Nodes.at(picked.at(end)).key, key) == 0) {
+                end++;
+            }
+            if (begin > 0 && end < picked.size()) {
+                std::reverse(picked.begin() + begin, picked.begin() + end);
+            } else {
+                const QVector<int> run = nodes(ascendingRank(first + begin, key), end - begin);
+                std::copy(run.begin(), run.end(), picked.begin() + begin);
+            }
+            begin = end;
+        }
+    }
+
+    result.reserve(count);
+    for (int node : qAsConst(picked)) {
+        result.append(m_Nodes.at(node).slot);
+    }
+    return result;
+}
+/**
+* @brief 取指定名次的行
+* @param rank 名次, 从 0 开始, 须在有效范围内
+* @param descending 是否按降序计算名次
+* @return 槽位号
+*/
+quint32 OrderedIndex::at(int rank, bool descending) const {
+    if (descending) {
+        const QVector<int> picked = nodes(size() - 1 - rank, 1);
+        if (picked.isEmpty()) {
+            return 0;
+        }
+        rank = ascendingRank(rank, m_Nodes.at(picked.first()).key);
+    }
+    int node = m_Root;
+    while (node >= 0) {
+        int leftSize = sizeOf(m_Nodes.at(node).left);
+        if (rank < leftSize) {
+            node = m_Nodes.at(node).left;
+        } else if (rank == leftSize) {
+            return m_Nodes.at(node).slot;
+        } else {
+            rank -= leftSize + 1;
+            node = m_Nodes.at(node).right;
+        }
+    }
+    return 0;
+}
+
+/**
+* @brief 按映射改写槽位号, 映射须保持槽位号的先后顺序, 树的结构不变
+* @param mapping 旧槽位号 -> 新槽位号
+*/
+void OrderedIndex::remap(const QVector<quint32> &mapping) {
+    // 空闲节点的槽位号已无意义, 越界的直接跳过
+    for (Node &node : m_Nodes) {
+        if (node.slot < quint32(mapping.size())) {
+            node.slot = mapping.at(int(node.slot));
+        }
+    }
+}
+
+OrderedIndex::Key OrderedIndex::makeKey(const QString &value) {
+    Key key;
+    bool ok = false;
+    double number = value.toDouble(&ok);
+    if (ok && !qIsNaN(number)) {
+        key.numeric = true;
+        key.number = number;
+    } else {
+        key.text = value;
+    }
+    return key;
+}
+/**
+* @brief 只比较取值, 返回负数、0、正数
+*/
+int OrderedIndex::compare(const Key &a, const Key &b) {
+    if (a.numeric != b.numeric) {
+        return a.numeric ? -1 : 1;
+    }
+    if (a.numeric) {
+        return a.number < b.number ? -1 : (a.number > b.number ? 1 : 0);
+    }
+    return a.text.compare(b.text);
+}
+/**
+* @brief 比较 (a, slotA) 是否排在 (b, slotB) 之前
+*/
+bool OrderedIndex::less(const Key &a, quint32 slotA, const Key &b, quint32 slotB) {
+    int cmp = compare(a, b);
+    if (cmp != 0) {
+        return cmp < 0;
+    }
+    return slotA < slotB;
+}
+int OrderedIndex::sizeOf(int node) const {
+    return node < 0 ? 0 : m_Nodes.at(node).size;
+}
+/**
+* @brief 从升序名次 start 开始中序取连续 count 个节点下标
+*/
+QVector<int> OrderedIndex::nodes(int start, int count) const {
+    QVector<int> result;
+    if (start < 0 || count <= 0) {
+        return result;
+    }
+    result.reserve(count);
+
+    // 下降到起始节点, 沿途向左经过的祖先都是之后的中序后继
+    QVector<int> stack;
+    int node = m_Root;
+    int rank = start;
+    while (node >= 0) {
+        int leftSize = sizeOf(m_Nodes.at(node).left);
+        if (rank < leftSize) {
+            stack.append(node);
+            node = m_Nodes.at(node).left;
+        } else if (rank == leftSize) {
+            stack.append(node);
+            break;
+        } else {
+            rank -= leftSize + 1;
+            node = m_Nodes.at(node).right;
+        }
+    }
+    // 中序遍历 count 个节点
+    while (!stack.isEmpty() && result.size() < count) {
+        int current = stack.takeLast();
+        result.append(current);
+        for (int child = m_Nodes.at(current).right; child >= 0; child = m_Nodes.at(child).left) {
+            stack.append(child);
+        }
+    }
+    return result;
+}
+/**
+* @brief 取值小于 key(inclusive 时小于等于)的元素个数
+*/
+int OrderedIndex::countBelow(const Key &key, bool inclusive) const {
+    int count = 0;
+    int node = m_Root;
+    while (node >= 0) {
+        int cmp = compare(m_Nodes.at(node).key, key);
+        if (cmp < 0 || (inclusive && cmp == 0)) {
+            count += sizeOf(m_Nodes.at(node).left) + 1;
+            node = m_Nodes.at(node).right;
+        } else {
+            node = m_Nodes.at(node).left;
+        }
+    }
+    return count;
+}
+/**
+* @brief 降序名次 rank 上的元素所在的同值区间换算为升序名次
+* @param rank 降序名次
+* @param key 该名次上元素的取值
+* @return 该元素的升序名次
+*/
+int OrderedIndex::ascendingRank(int rank, const Key &key) const {
+    // 同值区间在升序中占 [lower, upper), 降序中从 size() - upper 开始, 区间内仍按槽位号升序
+    int lower = countBelow(key, false);
+    int upper = countBelow(key, true);
+    return lower + rank - (size() - upper);
+}
+void OrderedIndex::update(int node) {
+    Node &n = m_Nodes[node];
+    n.size = 1 + sizeOf(n.left) + sizeOf(n.right);
+}
+/**
+* @brief 将子树按 (key, slot) 拆分为小于和不小于两部分
+*/
+void OrderedIndex::split(int node, const Key &key, quint32 slot, int &left, int &right) {
+    if (node < 0) {
+        left = right = -1;
+        return;
+    }
+    if (less(m_Nodes.at(node).key, m_Nodes.at(node).slot, key, slot)) {
+        int child = -1;
+        split(m_Nodes.at(node).right, key, slot, child, right);
+        m_Nodes[node].right = child;
+        left = node;
+    } else {
+        int child = -1;
+        split(m_Nodes.at(node).left, key, slot, left, child);
+        m_Nodes[node].left = child;
+        right = node;
+    }
+    update(node);
+}
+/**
+* @brief 合并两棵子树, left 中的元素须全部小于 right
+*/
+int OrderedIndex::merge(int left, int right) {
+    if (left < 0) {
+        return right;
+    }
+    if (right < 0) {
+        return left;
+    }
+    if (m_Nodes.at(left).priority > m_Nodes.at(right).priority) {
+        int child = merge(m_Nodes.at(left).right, right);
+        m_Nodes[left].right = child;
+        update(left);
+        return left;
+    }
+    int child = merge(left, m_Nodes.at(right).left);
+    m_Nodes[right].left = child;
+    update(right);
+    return right;
+}
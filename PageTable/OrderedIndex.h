@@ -0,0 +1,139 @@
+#ifndef ORDEREDINDEX_H
+#define ORDEREDINDEX_H
+
+#include <QVector>
+#include <QString>
+
+/**
+ * @author : LMH
+ * @date   : 2026.10.18
+ * @brief  : 顺序统计树, 按某一列的取值维护行的有序视图
+ *
+ * 以随机优先级的平衡树(treap)实现, 每个节点记录子树大小:
+ * 插入、删除和按名次定位都是 O(log n), 取连续 k 个名次为 O(log n + k)。
+ * 节点存放在连续数组中, 以下标互相引用, 不为每个节点单独分配内存。
+ * 数值取值按数值比较, 其余按字符串比较, 数值排在字符串之前; 取值相同时按槽位号排序,
+ * 降序时也按槽位号升序, 即相同取值的行在两个方向上都保持写入顺序。
+ */
+class OrderedIndex {
+
+public:
+    OrderedIndex();
+
+    /**
+     * @brief 元素数量
+     */
+    int size() const;
+    /**
+     * @brief 清空
+     */
+    void clear();
+    /**
+     * @brief 插入一行
+     * @param value 排序列的取值
+     * @param slot 行的槽位号
+     */
+    void insert(const QString &value, quint32 slot);
+    /**
+     * @brief 删除一行, 取值和槽位号须与插入时一致
+     * @param value 排序列的取值
+     * @param slot 行的槽位号
+     * @return 是否找到并删除
+     */
+    bool remove(const QString &value, quint32 slot);
+    /**
+     * @brief 按名次取连续的行
+     * @param first 起始名次, 从 0 开始
+     * @param count 数量
+     * @param descending 是否按降序计算名次
+     * @return 槽位号, 按名次排列
+     */
+    QVector<quint32> range(int first, int count, bool descending = false) const;
+    /**
+     * @brief 取指定名次的行
+     * @param rank 名次, 从 0 开始, 须在有效范围内
+     * @param descending 是否按降序计算名次
+     * @return 槽位号
+     */
+    quint32 at(int rank, bool descending = false) const;
+    /**
+     * @brief 按映射改写槽位号, 映射须保持槽位号的先后顺序, 树的结构不变
+     * @param mapping 旧槽位号 -> 新槽位号
+     */
+    void remap(const QVector<quint32> &mapping);
+
+private:
+    /**
+     * @brief 排序键: 能解析为数值时按数值比较
+     */
+    struct Key {
+        bool numeric = false;
+        double number = 0;
+        QString text;
+    };
+    /**
+     * @brief 树节点, 子节点以下标表示, -1 表示空
+     */
+    struct Node {
+        Key key;
+        quint32 slot = 0;
+        quint32 priority = 0;
+        int left = -1;
+        int right = -1;
+        int size = 1;
+    };
+
+    /**
+     * @brief 节点数组
+     */
+    QVector<Node> m_Nodes;
+    /**
+     * @brief 已删除可复用的节点下标
+     */
+    QVector<int> m_FreeNodes;
+    /**
+     * @brief 根节点下标
+     */
+    int m_Root;
+    /**
+     * @brief 优先级随机数状态
+     */
+    quint32 m_Seed;
+
+    static Key makeKey(const QString &value);
+    /**
+     * @brief 只比较取值, 返回负数、0、正数
+     */
+    static int compare(const Key &a, const Key &b);
+    /**
+     * @brief 比较 (a, slotA) 是否排在 (b, slotB) 之前
+     */
+    static bool less(const Key &a, quint32 slotA, const Key &b, quint32 slotB);
+    int sizeOf(int node) const;
+    /**
+     * @brief 从升序名次 start 开始中序取连续 count 个节点下标
+     */
+    QVector<int> nodes(int start, int count) const;
+    /**
+     * @brief 取值小于 key(inclusive 时小于等于)的元素个数
+     */
+    int countBelow(const Key &key, bool inclusive) const;
+    /**
+     * @brief 降序名次 rank 上的元素所在的同值区间换算为升序名次
+     * @param rank 降序名次
+     * @param key 该名次上元素的取值
+     * @return 该元素的升序名次
+     */
+    int ascendingRank(int rank, const Key &key) const;
+    void update(int node);
+    /**
+     * @brief 将子树按 (key, slot) 拆分为小于和不小于两部分
+     */
+    void split(int node, const Key &key, quint32 slot, int &left, int &right);
+    /**
+     * @brief 合并两棵子树, left 中的元素须全部小于 right
+     */
+    int merge(int left, int right);
+};
+
+#endif // ORDEREDINDEX_H
@@ -1,14 +1,58 @@
 #include "PageTable.h"
 
 #include <QDebug>
+#include <QSet>
 #include <QMutex>
+#include <QMap>
+#include <QWaitCondition>
+#include <QPointer>
+#include <QSharedPointer>
+#include <QThread>
 #include <QMessageBox>
+#include <QCoreApplication>
 #include <QPaintEvent>
+#include <QScrollBar>
 #include <QHeaderView>
+#include <QMetaMethod>
 #include <QMutexLocker>
 #include <QIntValidator>
 #include <QtCore/qmath.h>
+#include <QtConcurrent/QtConcurrent>
+#include <climits>
+#include <algorithm>
 #include "ObjectUtil.h"
+#include "FeedServer.h"
+#include "TableExporter.h"
+#include "PageTableModel.h"
+
+/**
+* @brief 异步更新的提交队列: 每次提交按顺序编号, 准备完成后按编号依次写入, 不因准备快慢而乱序
+*
+* 工作线程和组件所在线程都会访问, 成员均需加锁; 组件销毁后队列由仍在执行的工作线程持有,
+* 最后一个持有者释放时未写入的更新随之销毁, 对应的 QFuture 被取消。
+*/
+struct PageTable::AsyncQueue {
+    /**
+     * @brief 一次异步更新的状态: 等待准备、准备中、准备完成
+     */
+    enum State {
+        Queued,
+        Preparing,
+        Prepared
+    };
+    struct Update {
+        QList<QStringList> rows;
+        Operation operation = Append;
+        int index = -1;
+        QStringList errors;
+        State state = Queued;
+        QSharedPointer<QFutureInterface<UpdateResult>> promise;
+    };
+    QMutex mutex;
+    QWaitCondition prepared;
+    quint64 issued = 0;
+    QMap<quint64, Update> updates;
+};
 
 /************************** 公共方法 ****************************/
 /**
@@ -41,7 +85,8 @@ QVBoxLayout* PageTable::createObjWithLayout(QStringList header, QList<QStringLis
 * - 删除: 删除总数据中与传入数据匹配的所有数据。
 *
 * 注意：修改操作是基于index索引位置进行的。
-*      该方法在更新数据后会重新初始化分页信息和显示分页控件。
+*      该方法只更新数据, 分页信息和表格由刷新调度在下一帧合并刷新。
+*      此前提交的异步更新先按提交顺序写入, 保证调用顺序即写入顺序。
 */
 void PageTable::updateData(QList<QStringList> &data, Operation operation, int index) {
     QMutex mutex;
@@ -53,43 +98,728 @@ void PageTable::updateData(QList<QStringList> &data, Operation operation, int in
         return;
     }
 
+    applyAsyncUpdates(true);
+    applyUpdate(data, operation, index);
+}
+/**
+* @brief 异步更新数据
+* @param data 数据集合
+* @param operation 数据操作类型, 同 updateData
+* @param index 起始位置, 用于修改操作, 同 updateData
+* @return 更新结果的 QFuture, 包括受影响行数、更新后的总条数和错误信息
+*
+* 校验、去重等准备工作在线程池中执行, 不访问组件状态; 准备完成后回到组件所在线程写入数据。
+* 错误以结果值返回, 不弹出模态对话框, 可在非 GUI 线程调用。
+* 编码、索引同步和删除比较依赖存储的当前状态, 仍在组件所在线程执行。
+* 每次调用在提交时编号, 先准备完成的更新等待之前的更新写入后再写入, 写入顺序与调用顺序一致。
+*/
+QFuture<PageTable::UpdateResult> PageTable::updateDataAsync(const QList<QStringList> &data, Operation operation, int index) {
+    // 共享的 promise 在最后一个持有者释放时保证结束, 组件提前销毁时调用方不会一直等待
+    QSharedPointer<QFutureInterface<UpdateResult>> promise(new QFutureInterface<UpdateResult>(), [](QFutureInterface<UpdateResult> *p) {
+        if (!p->isFinished()) {
+            p->reportCanceled();
+            p->reportFinished();
+        }
+        delete p;
+    });
+    promise->reportStarted();
+    QFuture<UpdateResult> future = promise->future();
+
+    // 提交时编号并登记, 之后按编号顺序写入
+    QSharedPointer<AsyncQueue> queue = m_AsyncQueue;
+    quint64 sequence = 0;
+    {
+        QMutexLocker locker(&queue->mutex);
+        sequence = queue->issued++;
+        AsyncQueue::Update &update = queue->updates[sequence];
+        update.rows = data;
+        update.operation = operation;
+        update.index = index;
+        update.promise = promise;
+    }
+
+    QPointer<PageTable> self(this);
+    QtConcurrent::run([self, queue, sequence, operation, index]() {
+        QList<QStringList> rows;
+        {
+            QMutexLocker locker(&queue->mutex);
+            auto it = queue->updates.find(sequence);
+            // 同步更新等待时可能已在组件所在线程直接准备
+            if (it == queue->updates.end() || it->state != AsyncQueue::Queued) {
+                return;
+            }
+            it->state = AsyncQueue::Preparing;
+            rows = it->rows;
+        }
+        QStringList errors = prepareUpdate(rows, operation, index);
+        {
+            QMutexLocker locker(&queue->mutex);
+            auto it = queue->updates.find(sequence);
+            if (it != queue->updates.end()) {
+                it->rows = rows;
+                it->errors = errors;
+                it->state = AsyncQueue::Prepared;
+            }
+            queue->prepared.wakeAll();
+        }
+
+        if (self.isNull()) {
+            return;
+        }
+        // 回到组件所在线程, 按编号写入已准备完成的更新
+        QMetaObject::invokeMethod(self.data(), [self]() {
+            if (!self.isNull()) {
+                self->applyAsyncUpdates(false);
+            }
+        }, Qt::QueuedConnection);
+    });
+    return future;
+}
+/**
+* @brief 获取当前页数据
+* @return 当前页数据
+*/
+QList<QStringList> PageTable::getCurrentPageData() {
+    int startIndex = (m_CurrentPage - 1) * m_PageSize;
+    return viewRows(startIndex, m_PageSize);
+}
+/**
+* @brief 切换显示模式
+* @param mode 显示模式, 枚举定义, 包括分页和连续滚动
+*
+* 滚动模式使用固定行高的虚拟滚动视图, 只渲染视口内的行, 与数据总量无关;
+* 两种模式共用同一份数据和更新方法, 分页栏的当前页与滚动位置保持同步,
+* 点击页码会滚动到该页的首行。
+*/
+void PageTable::setDisplayMode(DisplayMode mode) {
+    if (mode == m_DisplayMode) {
+        return;
+    }
+    m_DisplayMode = mode;
+
+    if (mode == Scroll) {
+        // 分页模式下不维护模型, 切换时整体加载一次
+        m_Model->reload();
+        m_TableWidget->hide();
+        m_TableView->show();
+    } else {
+        m_TableView->hide();
+        m_TableWidget->show();
+    }
+    loadTable(m_CurrentPage);
+}
+/**
+* @brief 设置是否对低基数列启用字典编码
+* @param enabled 是否启用; 关闭时已编码的列全部还原为字符串存储
+*/
+void PageTable::setDictionaryEncoding(bool enabled) {
+    m_Data.setAutoEncoding(enabled);
+    scheduleCompaction();
+}
+/**
+* @brief 按指定列排序显示, 数据更新时增量维护排序
+* @param column 排序列索引, 小于 0 时取消排序视图
+* @param order 排序方向
+* @param limit 只显示排名前 limit 的行, 小于等于 0 表示显示全部
+*/
+void PageTable::setOrderedView(int column, Qt::SortOrder order, int limit) {
+    if (column < 0) {
+        clearOrderedView();
+        return;
+    }
+    // 排序列变化时重建顺序统计树; 只改变方向或显示数量时树不变
+    if (!m_OrderedActive || column != m_OrderColumn) {
+        m_OrderedIndex.clear();
+        for (int r = 0; r < m_Data.size(); r++) {
+            m_OrderedIndex.insert(m_Data.cell(r, column), m_Data.slotAt(r));
+        }
+    }
+    m_OrderedActive = true;
+    m_OrderColumn = column;
+    m_SortOrder = order;
+    m_OrderLimit = limit;
+    resetView();
+}
+/**
+* @brief 取消排序视图, 恢复按写入顺序显示
+*/
+void PageTable::clearOrderedView() {
+    if (!m_OrderedActive) {
+        return;
+    }
+    m_OrderedActive = false;
+    m_OrderedIndex.clear();
+    resetView();
+}
+/**
+* @brief 设置是否维护子串搜索索引
+* @param enabled 是否启用; 关闭时释放索引
+* @param columns 参与搜索的列, 为空表示全部列
+*/
+void PageTable::setSearchIndex(bool enabled, const QList<int> &columns) {
+    m_SearchIndexed = enabled;
+    m_SearchIndex.clear();
+    m_SearchIndex.setColumns(enabled ? columns : QList<int>());
+    if (enabled) {
+        for (int r = 0; r < m_Data.size(); r++) {
+            m_SearchIndex.insert(m_Data.slotAt(r), m_Data.row(r));
+        }
+    }
+    // 参与匹配的列可能变化, 重新执行当前搜索
+    if (m_SearchActive) {
+        search(m_SearchText);
+    }
+}
+/**
+* @brief 搜索包含指定文本的行, 忽略大小写, 结果按写入顺序分页显示
+* @param text 搜索文本, 为空时取消搜索
+*/
+void PageTable::search(const QString &text) {
+    if (text.isEmpty()) {
+        clearSearch();
+        return;
+    }
+    m_SearchText = text;
+    m_SearchResults.clear();
+
+    QVector<quint32> candidates;
+    if (m_SearchIndexed && m_SearchIndex.candidates(text, candidates)) {
+        // 倒排表交集只保证包含全部三元组, 逐个校验候选行
+        for (quint32 slot : qAsConst(candidates)) {
+            if (m_SearchIndex.matches(m_Data.rowAtSlot(slot), text)) {
+                m_SearchResults.append(slot);
+            }
+        }
+    } else {
+        for (int r = 0; r < m_Data.size(); r++) {
+            if (m_SearchIndex.matches(m_Data.row(r), text)) {
+                m_SearchResults.append(m_Data.slotAt(r));
+            }
+        }
+    }
+    m_SearchActive = true;
+    resetView();
+    setCurrentPage(1);
+}
+/**
+* @brief 取消搜索, 恢复显示全部行
+*/
+void PageTable::clearSearch() {
+    if (!m_SearchActive) {
+        return;
+    }
+    m_SearchActive = false;
+    m_SearchText.clear();
+    m_SearchResults.clear();
+    m_SearchResults.squeeze();
+    resetView();
+}
+/**
+* @brief 切换为分组汇总视图
+* @param groupColumn 分组列, 小于 0 时取消分组
+* @param aggregate 汇总方式
+* @param valueColumn 汇总列, 行数汇总时忽略
+* @param pivotColumn 透视列, 小于 0 表示不透视
+*/
+void PageTable::setGroupView(int groupColumn, GroupSummary::Aggregate aggregate, int valueColumn, int pivotColumn) {
+    if (groupColumn < 0) {
+        clearGroupView();
+        return;
+    }
+    const GroupSummary prototype(groupColumn, aggregate, valueColumn, pivotColumn);
+    m_GroupSummary = prototype;
+    m_GroupActive = true;
+    int generation = ++m_GroupGeneration;
+
+    // 快照按线程数分段, 之后的更新直接计入 m_GroupSummary, 与分段结果相加即为完整结果
+    const RowStore snapshot = m_Data;
+    int chunks = qMax(1, QThread::idealThreadCount());
+    int chunkRows = qMax(1, (snapshot.size() + chunks - 1) / chunks);
+    m_GroupPending = 0;
+    QPointer<PageTable> self(this);
+    for (int first = 0; first < snapshot.size(); first += chunkRows) {
+        int last = qMin(first + chunkRows, snapshot.size());
+        m_GroupPending++;
+        QtConcurrent::run([self, snapshot, prototype, first, last, generation]() {
+            // 只读访问会更新解压缓存, 每个任务使用独立的副本
+            RowStore local = snapshot;
+            GroupSummary partial = prototype;
+            for (int r = first; r < last; r++) {
+                partial.add(local.row(r));
+            }
+            QMetaObject::invokeMethod(QCoreApplication::instance(), [self, partial, generation]() {
+                if (!self.isNull()) {
+                    self->mergeGroupPartial(partial, generation);
+                }
+            }, Qt::QueuedConnection);
+        });
+    }
+    // 分段结果合并前, 行数归零的分组可能还有待抵消的合计, 暂不移除
+    m_GroupSummary.setDeferRemoval(m_GroupPending > 0);
+    resetView();
+}
+/**
+* @brief 取消分组汇总视图, 恢复显示明细行
+*/
+void PageTable::clearGroupView() {
+    if (!m_GroupActive) {
+        return;
+    }
+    m_GroupActive = false;
+    m_GroupGeneration++;
+    m_GroupPending = 0;
+    m_GroupSummary.clear();
+    resetView();
+}
+/**
+* @brief 获取搜索索引的规模统计
+* @return 统计信息, 包括三元组数量、倒排表条目数和内存占用
+*/
+TrigramIndex::Stats PageTable::searchIndexStats() const {
+    return m_SearchIndex.stats();
+}
+/**
+* @brief 设置列是否显示
+* @param column 列索引
+* @param visible 是否显示
+*/
+void PageTable::setColumnVisible(int column, bool visible) {
+    if (column < 0 || column >= m_TableHeader.size() || isColumnVisible(column) == visible) {
+        return;
+    }
+    if (visible) {
+        m_HiddenColumns.remove(column);
+    } else {
+        m_HiddenColumns.insert(column);
+    }
+    applyColumnVisibility();
+    applyColumnStorage(column);
+    // 预取的页按原来的显示列解码
+    m_PrefetchPages.clear();
+
+    // 重新显示的列需要补齐当前页
+    m_RenderRow = 0;
+    scheduleRefresh();
+}
+/**
+* @brief 指定列是否显示
+*/
+bool PageTable::isColumnVisible(int column) const {
+    return !m_HiddenColumns.contains(column);
+}
+/**
+* @brief 设置隐藏列的存储方式
+* @param storage 存储方式, 对已隐藏和之后隐藏的列生效
+*/
+void PageTable::setHiddenColumnStorage(RowStore::ColumnStorage storage) {
+    m_HiddenStorage = storage;
+    for (int column : qAsConst(m_HiddenColumns)) {
+        applyColumnStorage(column);
+    }
+}
+/**
+* @brief 在后台线程导出当前视图的数据
+* @param path 文件路径, 写入完成后才替换目标文件
+* @param format 导出格式, 枚举定义, 包括 CSV 和二进制
+* @return 导出是否成功的 QFuture
+*/
+QFuture<bool> PageTable::exportTo(const QString &path, ExportFormat format) {
+    // 复制存储和当前视图即得到一致的快照, 都是隐式共享, 之后的更新会自动分离, 不影响导出内容;
+    // 分离时槽位表、行顺序和视图索引整体复制一次, 代价见头文件说明;
+    // 视图的行在工作线程中按块取出, 不在界面线程展开整个视图
+    const RowStore snapshot = m_Data;
+    const QStringList header = viewHeader();
+    const qint64 total = viewCount();
+    const GroupSummary groups = m_GroupActive ? m_GroupSummary : GroupSummary();
+    const QVector<quint32> results = !m_GroupActive && m_SearchActive ? m_SearchResults : QVector<quint32>();
+    const OrderedIndex ordered = !m_GroupActive && !m_SearchActive && m_OrderedActive ? m_OrderedIndex : OrderedIndex();
+    const bool grouped = m_GroupActive;
+    const bool searched = !m_GroupActive && m_SearchActive;
+    const bool sorted = !m_GroupActive && !m_SearchActive && m_OrderedActive;
+    const bool descending = m_SortOrder == Qt::DescendingOrder;
+    QPointer<PageTable> self(this);
+
+    return QtConcurrent::run([self, snapshot, groups, results, ordered, grouped, searched, sorted, descending,
+                              total, header, path, format]() {
+        // 分组视图取汇总行, 搜索结果和排序视图按槽位号取行, 否则按存储顺序取行
+        auto source = [&](qint64 first, int count) {
+            if (grouped) {
+                return groups.rows(int(first), count);
+            }
+            QVector<quint32> picked;
+            if (searched) {
+                picked = results.mid(int(first), count);
+            } else if (sorted) {
+                picked = ordered.range(int(first), count, descending);
+            } else {
+                return snapshot.mid(int(first), count);
+            }
+            QList<QStringList> rows;
+            for (quint32 slot : qAsConst(picked)) {
+                rows.append(snapshot.rowAtSlot(slot));
+            }
+            return rows;
+        };
+
+        // 信号在组件所在线程发射, 组件已销毁时丢弃
+        auto notify = [self](std::function<void(PageTable*)> emitter) {
+            QMetaObject::invokeMethod(QCoreApplication::instance(), [self, emitter]() {
+                if (!self.isNull()) {
+                    emitter(self.data());
+                }
+            }, Qt::QueuedConnection);
+        };
+
+        QElapsedTimer clock;
+        clock.start();
+        auto progress = [&](qint64 written, qint64 total) {
+            if (written < total && clock.elapsed() < 100) {
+                return;
+            }
+            clock.restart();
+            notify([path, written, total](PageTable *table) {
+                emit table->exportProgress(path, written, total);
+            });
+        };
+
+        QString error;
+        bool ok = TableExporter::write(source, total, header, path, TableExporter::Format(format), progress, &error);
+        notify([path, ok, error](PageTable *table) {
+            emit table->exportFinished(path, ok, error);
+        });
+        return ok;
+    });
+}
+/**
+* @brief 开始在本地套接字上接收生产者进程发送的数据
+* @param name 本地服务名, 生产者以此名称连接
+* @return 是否监听成功
+*/
+bool PageTable::listenFeed(const QString &name) {
+    if (!m_FeedThread) {
+        qRegisterMetaType<FeedProtocol::Batch>("FeedProtocol::Batch");
+        m_FeedThread = new QThread(this);
+        m_FeedServer = new FeedServer();
+        m_FeedServer->moveToThread(m_FeedThread);
+        connect(m_FeedThread, &QThread::finished, m_FeedServer, &QObject::deleteLater);
+        connect(m_FeedServer, &FeedServer::batchReceived, this, &PageTable::applyFeedBatch);
+        connect(m_FeedServer, &FeedServer::clientError, this, [](const QString &message) {
+            qWarning() << "PageTable feed:" << message;
+        });
+        m_FeedThread->start();
+    }
+
+    // 服务对象属于接入线程, 在该线程中创建套接字并监听
+    bool ok = false;
+    QMetaObject::invokeMethod(m_FeedServer, "start", Qt::BlockingQueuedConnection,
+                              Q_RETURN_ARG(bool, ok), Q_ARG(QString, name));
+    return ok;
+}
+/**
+* @brief 停止接收数据并断开所有生产者连接
+*/
+void PageTable::closeFeed() {
+    if (!m_FeedThread) {
+        return;
+    }
+    QMetaObject::invokeMethod(m_FeedServer, "stop", Qt::BlockingQueuedConnection);
+    m_FeedThread->quit();
+    m_FeedThread->wait();
+    delete m_FeedThread;
+    m_FeedThread = nullptr;
+    m_FeedServer = nullptr;
+}
+/**
+* @brief 获取数据存储的内存占用统计
+* @return 统计信息, 包括数据块、存活/失效字节、行索引和字典的占用
+*/
+RowStore::MemoryStats PageTable::memoryStats() const {
+    return m_Data.memoryStats();
+}
+/**
+* @brief 设置冷块压缩
+* @param enabled 是否启用; 关闭时全部数据块解压还原
+* @param cacheBlocks 解压缓存最多保留的块数, 每块约 1MB; 越大翻页越快, 占用内存越多
+* @param level 压缩级别, 1 最快, 9 压缩率最高
+*/
+void PageTable::setColdCompression(bool enabled, int cacheBlocks, int level) {
+    m_Data.setCompression(enabled, cacheBlocks, level);
+    if (enabled) {
+        m_ColdTimer->start(1000);
+    } else {
+        m_ColdTimer->stop();
+    }
+}
+/**
+* @brief 设置刷新调度参数
+* @param maxFps 最大刷新帧率, 两次刷新之间至少间隔 1000/maxFps 毫秒; 小于等于 0 表示不限制
+* @param frameBudgetMs 单帧时间预算(毫秒), 超出后剩余的单元格顺延到下一帧; 小于等于 0 表示不限制
+*/
+void PageTable::setRefreshRate(int maxFps, int frameBudgetMs) {
+    m_FrameInterval = maxFps > 0 ? 1000 / maxFps : 0;
+    m_FrameBudget = frameBudgetMs;
+}
+/**
+* @brief 设置自适应分页
+* @param enabled 是否启用; 关闭时保持当前每页条数并释放预取的页
+* @param targetMs 翻页延迟目标(毫秒)
+* @param minPageSize 每页条数下限
+* @param maxPageSize 每页条数上限
+* @param maxPrefetch 最多预取的相邻页数, 0 表示不预取
+*/
+void PageTable::setAdaptivePaging(bool enabled, int targetMs, int minPageSize, int maxPageSize, int maxPrefetch) {
+    m_Adaptive = enabled;
+    m_LatencyTarget = qMax(1, targetMs);
+    m_MinPageSize = qMax(1, minPageSize);
+    m_MaxPageSize = qMax(m_MinPageSize, maxPageSize);
+    m_MaxPrefetch = qMax(0, maxPrefetch);
+    m_NavPage = m_CurrentPage;
+    m_NavRun = 0;
+    m_PrefetchPages.clear();
+    m_PrefetchTimer->stop();
+    if (!enabled) {
+        m_PendingPageSize = 0;
+        return;
+    }
+    // 已有测量结果时按新目标立即评估一次
+    tunePageSize();
+}
+/**
+* @brief 获取自适应分页的测量结果和决策
+*/
+PageTable::PagingStats PageTable::pagingStats() const {
+    PagingStats stats;
+    stats.adaptive = m_Adaptive;
+    stats.targetMs = m_LatencyTarget;
+    stats.pageSize = m_PageSize;
+    stats.rowCostMs = m_RowCost;
+    stats.pagerCostMs = m_PagerCost;
+    stats.prefetchDepth = m_MaxPrefetch > 0 ? qMin(qMax(1, qAbs(m_NavRun)), m_MaxPrefetch) : 0;
+    stats.prefetchDirection = m_NavRun > 0 ? 1 : (m_NavRun < 0 ? -1 : 0);
+    stats.cachedPages = m_PrefetchPages.size();
+    stats.prefetchHits = m_PrefetchHits;
+    stats.prefetchMisses = m_PrefetchMisses;
+    return stats;
+}
+
+/************************** 限制方法 ****************************/
+// 私有方法
+/**
+* @brief 写入数据变更并请求刷新, 调用前应已完成参数校验
+* @param data 数据集合
+* @param operation 数据操作类型
+* @param index 起始位置, 用于修改操作
+* @return 受影响的行数
+*/
+int PageTable::applyUpdate(const QList<QStringList> &data, Operation operation, int index) {
+    int oldSize = m_Data.size();
+    int affected = data.size();
+    // 有视图索引时逐行同步, 修改前先取出旧行; 无人订阅变更时不记录
+    bool indexed = hasRowIndexes();
+    bool tracked = isSignalConnected(QMetaMethod::fromSignal(&PageTable::dataChanged));
     switch (operation) {
-    case Append: m_Data.append(data); break; // 追加数据
+    case Append:
+        m_Data.append(data); // 追加数据
+        for (int i = 0; indexed && i < data.size(); i++) {
+            rowInserted(m_Data.slotAt(oldSize + i), data.at(i));
+        }
+        if (tracked && !data.isEmpty()) {
+            recordChange(RowChange::Inserted, oldSize, data.size());
+        }
+        markDirty(oldSize, m_Data.size() - 1);
+        break;
     case Modify:
         // 修改数据
         for (int i = 0; i < data.size(); ++i) {
             int dataIndex = index + i;
             if (dataIndex < m_Data.size()) {
-                m_Data[dataIndex] = data[i];
+                quint32 slot = m_Data.slotAt(dataIndex);
+                QStringList old;
+                if (indexed || tracked) {
+                    old = m_Data.row(dataIndex);
+                }
+                if (indexed) {
+                    rowRemoved(slot, old);
+                }
+                m_Data.set(dataIndex, data[i]);
+                if (indexed) {
+                    rowInserted(slot, data.at(i));
+                }
+                if (tracked) {
+                    // 只通知取值真正变化的列
+                    const QStringList current = m_Data.stored(data.at(i));
+                    QBitArray columns(qMax(old.size(), current.size()));
+                    for (int c = 0; c < columns.size(); c++) {
+                        columns.setBit(c, old.value(c) != current.value(c));
+                    }
+                    recordChange(RowChange::Updated, dataIndex, 1, columns);
+                }
             } else {
                 // 如果索引越界，则追加数据
                 m_Data.append(data[i]);
+                if (indexed) {
+                    rowInserted(m_Data.slotAt(m_Data.size() - 1), data.at(i));
+                }
+                if (tracked) {
+                    recordChange(RowChange::Inserted, m_Data.size() - 1, 1);
+                }
             }
         }
+        markDirty(qMin(index, oldSize), index + data.size() - 1);
         break;
-    case Delete:
+    case Delete: {
         // 删除数据
-        for (int i = 0; i < data.size(); ++i) {
-            m_Data.removeAll(data[i]);
+        QVector<RowStore::RemovedRow> removed;
+        affected = m_Data.removeAll(data, indexed || tracked ? &removed : nullptr);
+        for (int i = 0; i < removed.size(); i++) {
+            const RowStore::RemovedRow &entry = removed.at(i);
+            if (indexed) {
+                rowRemoved(entry.slot, data.at(entry.match));
+            }
+            // 按顺序应用时前面已删除 i 行, 行索引随之前移
+            if (tracked) {
+                recordChange(RowChange::Removed, entry.row - i, 1);
+            }
         }
+        // 删除位置不连续, 整体标记
+        m_ResetPending = m_ResetPending || affected > 0;
+        markDirty(0, INT_MAX);
         break;
     }
+    }
 
-    m_Total = m_Data.size();
-    initialize();
+    // 搜索结果和排序视图中变更行的位置与写入位置无关, 整体标记
+    if (m_SearchActive || m_OrderedActive) {
+        markDirty(0, INT_MAX);
+    }
+    // 分组数量和透视列都可能变化, 整体重载
+    if (m_GroupActive) {
+        m_ResetPending = true;
+        markDirty(0, INT_MAX);
+    }
+    m_Total = viewCount();
+    // 视图行数少于模型已公布的行数时无法增量通知(如搜索中修改行使其不再匹配), 整体重载
+    if (m_Total < m_Model->rowCount()) {
+        m_ResetPending = true;
+    }
+
+    // 修改和删除会留下失效记录, 追加可能改变列的编码方式, 空闲时整理
+    scheduleCompaction();
+
+    // 不立即重绘, 由刷新调度合并到下一帧
+    scheduleRefresh();
+    return affected;
 }
 /**
-* @brief 获取当前页数据
-* @return 当前页数据
+* @brief 按提交顺序写入已准备完成的异步更新
+* @param wait 是否写入此前提交的全部更新: 准备中的等待其完成, 尚未开始准备的直接在当前线程准备;
+*             为 false 时遇到未准备完成的更新即停止, 留给之后的调用
 */
-QList<QStringList> PageTable::getCurrentPageData() {
-    int startIndex = (m_CurrentPage - 1) * m_PageSize;
-    int endIndex = qMin(startIndex + m_PageSize, m_Data.size());
-    return m_Data.mid(startIndex, endIndex - startIndex);
+void PageTable::applyAsyncUpdates(bool wait) {
+    QMutexLocker locker(&m_AsyncQueue->mutex);
+    QMap<quint64, AsyncQueue::Update> &updates = m_AsyncQueue->updates;
+    quint64 end = m_AsyncQueue->issued;
+    while (!updates.isEmpty() && updates.firstKey() < end) {
+        auto head = updates.begin();
+        if (head->state != AsyncQueue::Prepared) {
+            if (!wait) {
+                break;
+            }
+            if (head->state == AsyncQueue::Preparing) {
+                m_AsyncQueue->prepared.wait(&m_AsyncQueue->mutex);
+                continue;
+            }
+            // 线程池尚未开始执行, 不必等待排队, 直接准备
+            quint64 sequence = head.key();
+            head->state = AsyncQueue::Preparing;
+            QList<QStringList> rows = head->rows;
+            Operation operation = head->operation;
+            int index = head->index;
+            locker.unlock();
+            QStringList errors = prepareUpdate(rows, operation, index);
+            locker.relock();
+            head = updates.find(sequence);
+            head->rows = rows;
+            head->errors = errors;
+            head->state = AsyncQueue::Prepared;
+        }
+
+        AsyncQueue::Update update = head.value();
+        updates.erase(head);
+        // 写入期间不持有锁, 工作线程可以继续登记准备结果
+        locker.unlock();
+        UpdateResult result;
+        result.errors = update.errors;
+        if (!(update.operation == Modify && update.index < 0)) {
+            result.rowsAffected = applyUpdate(update.rows, update.operation, update.index);
+            result.total = m_Total;
+        }
+        update.promise->reportResult(result);
+        update.promise->reportFinished();
+        locker.relock();
+    }
 }
+/**
+* @brief 记录一项数据变更, 与上一项相邻且类型相同时合并
+* @param kind 变更类型
+* @param first 起始行, 按顺序应用之前各项变更后的行索引
+* @param count 行数
+* @param columns 修改的列, 仅用于修改
+*/
+void PageTable::recordChange(RowChange::Kind kind, int first, int count, const QBitArray &columns) {
+    if (!m_PendingChanges.isEmpty()) {
+        RowChange &last = m_PendingChanges.last();
+        // 删除后相邻的行前移到同一位置, 其余类型要求首尾相接
+        bool adjacent = kind == RowChange::Removed ? first == last.first : first == last.first + last.count;
+        if (last.kind == kind && adjacent && last.columns == columns) {
+            last.count += count;
+            return;
+        }
+    }
+    RowChange change;
+    change.kind = kind;
+    change.first = first;
+    change.count = count;
+    change.columns = columns;
+    m_PendingChanges.append(change);
+}
+/**
+* @brief 校验并整理待更新的数据, 只依赖参数, 可在工作线程执行
+* @param data 数据集合, 校验时可能被截断或去重
+* @param operation 数据操作类型
+* @param index 起始位置, 用于修改操作
+* @return 错误信息, 为空表示校验通过
+*/
+QStringList PageTable::prepareUpdate(QList<QStringList> &data, Operation operation, int index) {
+    QStringList errors;
+    if (operation == Modify && index < 0) {
+        errors << QString::fromUtf8("修改操作必须传入显式有效的index。");
+        data.clear();
+        return errors;
+    }
 
-/************************** 限制方法 ****************************/
-// 私有方法
+    // 单行单元格数量受存储格式限制
+    for (int i = 0; i < data.size(); i++) {
+        if (data.at(i).size() > 0xFFFF) {
+            data[i] = data.at(i).mid(0, 0xFFFF);
+            errors << QString::fromUtf8("第%1行单元格数量超过上限, 已截断。").arg(i + 1);
+        }
+    }
+
+    // 删除按整行匹配, 相同的行只需比较一次
+    if (operation == Delete) {
+        QSet<QStringList> seen;
+        QList<QStringList> unique;
+        for (const QStringList &row : qAsConst(data)) {
+            if (!seen.contains(row)) {
+                seen.insert(row);
+                unique.append(row);
+            }
+        }
+        data = unique;
+    }
+    return errors;
+}
 /**
 * @brief 初始化方法, 用于设置分页信息和显示分页控件
 */
@@ -114,7 +844,7 @@ void PageTable::initialize() {
     m_PageBtnCount = (m_PageCount <= m_MiddleBtnCount) ? (m_PageCount + 2) : (m_MiddleBtnCount + 2);
 
     // 设置显示文本
-    m_TotalText->setText(QString::fromUtf8("共%1条").arg(m_Data.size()));
+    m_TotalText->setText(QString::fromUtf8("共%1条").arg(viewCount()));
     m_StartBtn->setText(QString("%1").arg(1));
     m_EndBtn->setText(QString("%1").arg(m_PageCount));
 
@@ -151,7 +881,6 @@ void PageTable::initialize() {
     m_NavigationLayout->addItem(m_NaviLayoutSpacer);
 
     m_NavigationLayout->addStretch(); // 添加伸缩空间
-    setCurrentPage(m_CurrentPage); // 设置当前页
 }
 /**
 * @brief 更新分页按钮列表
@@ -247,38 +976,631 @@ void PageTable::loadTable(int pageIndex) {
     QMutex mutex;
     QMutexLocker locker(&mutex);
 
-    int pageSize = m_PageSize;
-    int startIndex = (pageIndex - 1) * pageSize;
-    int endIndex = startIndex + pageSize;
+    // 滚动模式: 视口首行不在目标页时滚动到该页首行, 由视图负责渲染
+    if (m_DisplayMode == Scroll) {
+        int firstRow = (pageIndex - 1) * m_PageSize;
+        int topRow = m_TableView->rowAt(0);
+        if (pageIndex == m_CurrentPage && firstRow >= 0 && firstRow < m_Model->rowCount()
+            && (topRow < 0 || topRow / m_PageSize + 1 != pageIndex)) {
+            m_SyncingScroll = true;
+            m_TableView->scrollTo(m_Model->index(firstRow, 0), QAbstractItemView::PositionAtTop);
+            m_SyncingScroll = false;
+        }
+        return;
+    }
 
     // 无效的 pageIndex 或者不是当前页面, 不刷新
-    if (startIndex < 0 || endIndex > m_Data.size() || pageIndex != m_CurrentPage) {
+    if (pageIndex < 1 || pageIndex != m_CurrentPage) {
         return;
     }
 
-    // 只更新变化的单元格
-    for (int i = 0; i < pageSize; i++) {
-        int row = i;
-        int dataIdx = startIndex + i;
-        QStringList items = m_Data[dataIdx];
+    // 页面切换时立即完整刷新, 不受帧预算限制
+    m_RenderRow = 0;
+    if (!m_Adaptive) {
+        renderRows(0);
+        return;
+    }
+
+    // 识别翻页方式: 连续逐页翻页累计次数, 跳页清零, 原地刷新不计
+    int step = pageIndex - m_NavPage;
+    if (step == 1 || step == -1) {
+        m_NavRun = (m_NavRun * step > 0) ? m_NavRun + step : step;
+    } else if (step != 0) {
+        m_NavRun = 0;
+    }
+    m_NavPage = pageIndex;
+
+    bool prefetched = m_PrefetchPages.contains(pageIndex);
+    QElapsedTimer clock;
+    clock.start();
+    renderRows(0);
+    if (prefetched) {
+        m_PrefetchHits++;
+    } else {
+        // 只用未命中预取的完整渲染估计每行耗时, 估计偏保守
+        m_PrefetchMisses++;
+        double sample = clock.nsecsElapsed() / 1e6 / qMax(1, m_PageSize);
+        m_RowCost = m_RowCost > 0 ? m_RowCost * 0.7 + sample * 0.3 : sample;
+        tunePageSize();
+    }
 
-        if (dataIdx >= m_Data.size()) {
-            continue;  // 超出数据范围，跳过处理
+    // 淘汰不再需要的预取页, 空闲时继续预取
+    const QList<int> targets = prefetchTargets();
+    for (auto it = m_PrefetchPages.begin(); it != m_PrefetchPages.end();) {
+        if (it.key() != pageIndex && !targets.contains(it.key())) {
+            it = m_PrefetchPages.erase(it);
+        } else {
+            ++it;
         }
+    }
+    m_PrefetchTimer->start(qMax(m_FrameInterval, 16));
+}
 
-        for (int j = 0; j < items.size(); j++) {
+/**
+* @brief 滚动模式下根据视口首行同步当前页
+*/
+void PageTable::syncPageWithScroll() {
+    if (m_DisplayMode != Scroll || m_SyncingScroll) {
+        return;
+    }
+    int topRow = m_TableView->rowAt(0);
+    if (topRow < 0) {
+        return;
+    }
+    int page = topRow / m_PageSize + 1;
+    if (page != m_CurrentPage) {
+        setCurrentPage(page);
+    }
+}
+
+/**
+* @brief 刷新调度的单帧处理: 合并期间的所有数据变更, 刷新分页栏和当前页
+*/
+void PageTable::refreshFrame() {
+    // 变更通知不受输入优先影响, 每帧合并为一批发出
+    if (!m_PendingChanges.isEmpty()) {
+        ChangeBatch changes;
+        changes.swap(m_PendingChanges);
+        emit dataChanged(changes, m_Data.size());
+    }
+
+    // 输入优先: 距上次用户输入不足一帧时让出本帧; 连续让出有上限, 避免数据长期得不到刷新
+    if (m_InputClock.isValid() && m_InputClock.elapsed() < qMax(m_FrameInterval, 16) && m_DeferredFrames < 3) {
+        m_DeferredFrames++;
+        m_RefreshTimer->start(qMax(m_FrameInterval, 16));
+        return;
+    }
+    m_DeferredFrames = 0;
+    m_FrameClock.restart();
+
+    if (m_PagerDirty) {
+        m_PagerDirty = false;
+        applyViewHeader();
+        flushModel();
+
+        // 自适应分页调整了每页条数时, 跳到原当前页首行所在的页
+        int target = m_CurrentPage;
+        if (m_PendingPageSize > 0) {
+            target = applyPageSize(m_PendingPageSize);
+            m_PendingPageSize = 0;
+        }
+
+        // 页码按钮数量不变时只更新文本, 不重建按钮, 避免打断正在进行的点击
+        int pageCount = (m_Total + m_PageSize - 1) / m_PageSize;
+        int pageBtnCount = (pageCount <= m_MiddleBtnCount) ? (pageCount + 2) : (m_MiddleBtnCount + 2);
+        if (pageBtnCount != m_PageBtnCount) {
+            initialize();
+        } else {
+            m_PageCount = pageCount;
+            m_TotalText->setText(QString::fromUtf8("共%1条").arg(viewCount()));
+            m_EndBtn->setText(QString("%1").arg(m_PageCount));
+        }
+
+        // 当前页超出总页数时跳转到最后一页, 否则只刷新分页栏
+        int page = qMax(1, qMin(target, m_PageCount));
+        if (page != m_CurrentPage) {
+            setCurrentPage(page);
+        } else {
+            refreshPager(page);
+            // 只有当前页与变更区间相交时才需要重绘表格
+            int firstRow = (m_CurrentPage - 1) * m_PageSize;
+            int lastRow = firstRow + m_PageSize - 1;
+            if (m_DisplayMode == Paged && m_DirtyFirst <= lastRow && m_DirtyLast >= firstRow) {
+                m_RenderRow = 0;
+            }
+        }
+        m_DirtyFirst = INT_MAX;
+        m_DirtyLast = -1;
+    }
+
+    // 按剩余的帧预算刷新单元格, 未完成的部分顺延到下一帧
+    if (m_RenderRow >= 0) {
+        int budget = m_FrameBudget > 0 ? qMax(1, m_FrameBudget - int(m_FrameClock.elapsed())) : 0;
+        if (!renderRows(budget)) {
+            m_RefreshTimer->start(0);
+        }
+    }
+}
+/**
+* @brief 请求在下一帧刷新; 两帧之间的多次请求合并为一次
+*/
+void PageTable::scheduleRefresh() {
+    m_PagerDirty = true;
+    if (m_RefreshTimer->isActive()) {
+        return;
+    }
+    int wait = m_FrameClock.isValid() ? m_FrameInterval - int(m_FrameClock.elapsed()) : 0;
+    m_RefreshTimer->start(qMax(0, wait));
+}
+/**
+* @brief 记录待刷新的数据区间, 与已有区间合并
+* @param first 起始行
+* @param last 结束行(包含)
+*/
+void PageTable::markDirty(int first, int last) {
+    m_DirtyFirst = qMin(m_DirtyFirst, first);
+    m_DirtyLast = qMax(m_DirtyLast, last);
+
+    // 作废与变更区间相交的预取页; 排序、搜索和分组视图中行的位置随数据变化, 全部作废
+    if (m_OrderedActive || m_SearchActive || m_GroupActive) {
+        m_PrefetchPages.clear();
+        return;
+    }
+    for (auto it = m_PrefetchPages.begin(); it != m_PrefetchPages.end();) {
+        int firstRow = (it.key() - 1) * m_PageSize;
+        if (first <= firstRow + m_PageSize - 1 && last >= firstRow) {
+            it = m_PrefetchPages.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+/**
+* @brief 将合并后的数据变更通知给滚动模式的模型
+*/
+void PageTable::flushModel() {
+    if (m_DisplayMode == Scroll) {
+        if (m_ResetPending) {
+            m_Model->reload();
+            applyColumnVisibility();
+        } else {
+            m_Model->rowsChanged(m_DirtyFirst, m_DirtyLast);
+            m_Model->rowsAppended(viewCount());
+        }
+    }
+    m_ResetPending = false;
+}
+/**
+* @brief 从 m_RenderRow 开始逐行刷新当前页的单元格, 只更新发生变化的单元格
+* @param budgetMs 时间预算(毫秒), 超出时记录进度留待下一帧; 小于等于 0 表示不限制
+* @return 当前页是否已全部刷新
+*/
+bool PageTable::renderRows(int budgetMs) {
+    QElapsedTimer clock;
+    clock.start();
+
+    // 开始刷新一页时按视图顺序取出整页, 分帧刷新期间复用
+    if (m_RenderRow <= 0) {
+        auto prefetched = m_PrefetchPages.constFind(m_CurrentPage);
+        m_PageRows = prefetched != m_PrefetchPages.constEnd()
+            ? prefetched.value()
+            : viewRows((m_CurrentPage - 1) * m_PageSize, m_PageSize, visibleColumns());
+    }
+    for (int row = qMax(0, m_RenderRow); row < m_PageSize; row++) {
+        bool hasData = row < m_PageRows.size();
+
+        for (int j = 0; j < m_TableWidget->columnCount(); j++) {
+            // 隐藏的列既不解码也不比较
+            if (m_TableWidget->isColumnHidden(j)) {
+                continue;
+            }
+            // 超出数据范围的行(最后一页不满时)清空显示
+            QString text = hasData ? m_PageRows.at(row).value(j) : QString();
+            if (hasData && (text.isEmpty() || text == "nan")) {
+                text = "--";
+            }
             QTableWidgetItem* cell = m_TableWidget->item(row, j);
             if (!cell) {
+                if (!hasData) {
+                    continue;
+                }
                 // 单元格不存在，创建并设置属性
-                cell = new QTableWidgetItem(items[j]);
+                cell = new QTableWidgetItem(text);
                 cell->setFont(m_Font);
-                m_TableWidget->setItem(row, j, cell);
                 cell->setTextAlignment(Qt::AlignCenter);
-            } else if (cell->text() != items[j]) {
+                m_TableWidget->setItem(row, j, cell);
+            } else if (cell->text() != text) {
                 // 仅更新发生变化的单元格
-                cell->setText(items[j].isEmpty() || items[j] == "nan" ? "--" : items[j]);
+                cell->setText(text);
             }
         }
+
+        if (budgetMs > 0 && clock.elapsed() >= budgetMs && row + 1 < m_PageSize) {
+            m_RenderRow = row + 1;
+            return false;
+        }
+    }
+    m_RenderRow = -1;
+    m_PageRows.clear();
+    return true;
+}
+/**
+* @brief 当前视图的行数; 排序视图受显示数量限制
+*/
+int PageTable::viewCount() const {
+    if (m_GroupActive) {
+        return m_GroupSummary.groupCount();
+    }
+    if (m_SearchActive) {
+        return m_SearchResults.size();
+    }
+    if (!m_OrderedActive) {
+        return m_Data.size();
+    }
+    int count = m_OrderedIndex.size();
+    return m_OrderLimit > 0 ? qMin(count, m_OrderLimit) : count;
+}
+/**
+* @brief 按视图顺序获取指定区间的行
+* @param first 起始位置
+* @param count 行数
+* @param columns 只解码位为 1 的列, 为空表示全部列; 分组视图忽略
+* @return 行数据集合
+*/
+QList<QStringList> PageTable::viewRows(int first, int count, const QBitArray &columns) const {
+    count = qMin(count, viewCount() - first);
+    if (first < 0 || count <= 0) {
+        return QList<QStringList>();
+    }
+    if (m_GroupActive) {
+        return m_GroupSummary.rows(first, count);
+    }
+    QList<QStringList> rows;
+    if (!m_SearchActive && !m_OrderedActive) {
+        for (int r = first; r < first + count; r++) {
+            rows.append(m_Data.row(r, columns));
+        }
+        return rows;
+    }
+    // 排序视图按名次定位起点后顺序遍历, 一页为 O(log n + count)
+    const QVector<quint32> pageSlots = m_SearchActive ? m_SearchResults.mid(first, count)
+        : m_OrderedIndex.range(first, count, m_SortOrder == Qt::DescendingOrder);
+    for (quint32 slot : pageSlots) {
+        rows.append(m_Data.rowAtSlot(slot, columns));
+    }
+    return rows;
+}
+/**
+* @brief 按视图顺序获取单元格
+* @param row 视图中的行位置
+* @param column 列索引
+* @return 单元格文本
+*/
+QString PageTable::viewCell(int row, int column) const {
+    if (m_GroupActive) {
+        return m_GroupSummary.cell(row, column);
+    }
+    if (!m_SearchActive && !m_OrderedActive) {
+        return m_Data.cell(row, column);
+    }
+    // 只解码目标列
+    QBitArray mask(column + 1);
+    mask.setBit(column);
+    quint32 slot = m_SearchActive ? m_SearchResults.value(row) : m_OrderedIndex.at(row, m_SortOrder == Qt::DescendingOrder);
+    return m_Data.rowAtSlot(slot, mask).value(column);
+}
+/**
+* @brief 是否有需要随数据变更同步的视图索引
+*/
+bool PageTable::hasRowIndexes() const {
+    return m_OrderedActive || m_SearchIndexed || m_SearchActive || m_GroupActive;
+}
+/**
+* @brief 同步视图索引: 新增一行
+* @param slot 行的槽位号
+* @param values 行数据
+*/
+void PageTable::rowInserted(quint32 slot, const QStringList &values) {
+    // 按写入后读取得到的形式同步, 移除时才能与索引中的取值一致
+    const QStringList row = m_Data.stored(values);
+    if (m_OrderedActive) {
+        m_OrderedIndex.insert(row.value(m_OrderColumn), slot);
+    }
+    if (m_SearchIndexed) {
+        m_SearchIndex.insert(slot, row);
+    }
+    if (m_GroupActive) {
+        m_GroupSummary.add(row, 1);
+    }
+    // 新行或修改后的行匹配当前搜索时按槽位号插入结果
+    if (m_SearchActive && m_SearchIndex.matches(row, m_SearchText)) {
+        auto it = std::lower_bound(m_SearchResults.begin(), m_SearchResults.end(), slot);
+        if (it == m_SearchResults.end() || *it != slot) {
+            m_SearchResults.insert(it, slot);
+        }
+    }
+}
+/**
+* @brief 同步视图索引: 移除一行
+* @param slot 行的槽位号
+* @param values 移除前的行数据
+*/
+void PageTable::rowRemoved(quint32 slot, const QStringList &values) {
+    const QStringList row = m_Data.stored(values);
+    if (m_OrderedActive) {
+        m_OrderedIndex.remove(row.value(m_OrderColumn), slot);
+    }
+    if (m_SearchIndexed) {
+        m_SearchIndex.remove(slot, row);
+    }
+    if (m_GroupActive) {
+        m_GroupSummary.add(row, -1);
+    }
+    if (m_SearchActive) {
+        auto it = std::lower_bound(m_SearchResults.begin(), m_SearchResults.end(), slot);
+        if (it != m_SearchResults.end() && *it == slot) {
+            m_SearchResults.erase(it);
+        }
+    }
+}
+/**
+* @brief 渲染时需要解码的列; 没有隐藏列或显示分组汇总时为空, 表示全部列
+*/
+QBitArray PageTable::visibleColumns() const {
+    if (m_HiddenColumns.isEmpty() || m_GroupActive) {
+        return QBitArray();
+    }
+    QBitArray columns(m_TableHeader.size(), true);
+    for (int column : m_HiddenColumns) {
+        columns.clearBit(column);
+    }
+    return columns;
+}
+/**
+* @brief 将列的显示状态应用到分页表格和滚动视图; 分组视图的列与原始列不对应, 全部显示
+*/
+void PageTable::applyColumnVisibility() {
+    for (int j = 0; j < m_TableWidget->columnCount(); j++) {
+        bool hidden = !m_GroupActive && m_HiddenColumns.contains(j);
+        m_TableWidget->setColumnHidden(j, hidden);
+        m_TableView->setColumnHidden(j, hidden);
+    }
+}
+/**
+* @brief 按列的显示状态调整其存储方式: 隐藏的列按设置丢弃或溢出, 显示的列常驻内存
+*/
+void PageTable::applyColumnStorage(int column) {
+    RowStore::ColumnStorage storage = isColumnVisible(column) ? RowStore::Inline : m_HiddenStorage;
+    // 丢弃的列不再恢复取值, 重新显示时保持丢弃前的状态: 已有行为空, 新行照常保存
+    if (storage == m_Data.columnStorage(column)) {
+        return;
+    }
+    m_Data.setColumnStorage(column, storage);
+    scheduleCompaction();
+    // 丢弃改变了已有行的取值, 按新取值重建视图索引, 之后的移除才能定位到索引中的条目
+    if (storage == RowStore::Dropped && hasRowIndexes()) {
+        rebuildRowIndexes();
+    }
+}
+/**
+* @brief 按当前存储的取值重建全部视图索引
+*/
+void PageTable::rebuildRowIndexes() {
+    m_OrderedIndex.clear();
+    m_SearchIndex.clear();
+    if (m_GroupActive) {
+        // 丢弃尚未合并的后台分段结果, 同步重新汇总
+        m_GroupGeneration++;
+        m_GroupPending = 0;
+        m_GroupSummary.clear();
+    }
+    bool searching = m_SearchActive;
+    m_SearchActive = false;
+    for (int r = 0; r < m_Data.size(); r++) {
+        rowInserted(m_Data.slotAt(r), m_Data.row(r));
+    }
+    if (searching) {
+        search(m_SearchText);
+    } else {
+        resetView();
+    }
+}
+/**
+* @brief 当前视图的表头
+*/
+QStringList PageTable::viewHeader() const {
+    return m_GroupActive ? m_GroupSummary.header(m_TableHeader) : m_TableHeader;
+}
+/**
+* @brief 表头变化时更新表格列和滚动模式的模型
+*/
+void PageTable::applyViewHeader() {
+    QStringList header = viewHeader();
+    if (header == m_ViewHeader) {
+        return;
+    }
+    m_ViewHeader = header;
+    m_TableWidget->setColumnCount(header.size());
+    m_TableWidget->setHorizontalHeaderLabels(header);
+    applyColumnVisibility();
+    m_ResetPending = true;
+    m_RenderRow = 0;
+}
+/**
+* @brief 合并一段分组统计结果
+* @param partial 分段统计结果
+* @param generation 统计开始时的分组视图版本号
+*/
+void PageTable::mergeGroupPartial(const GroupSummary &partial, int generation) {
+    if (!m_GroupActive || generation != m_GroupGeneration) {
+        return;
+    }
+    m_GroupSummary.merge(partial);
+    if (--m_GroupPending == 0) {
+        m_GroupSummary.setDeferRemoval(false);
+    }
+    resetView();
+}
+/**
+* @brief 视图切换后重新计算总数并整体刷新, 当前页超出范围时由刷新调度调整
+*/
+void PageTable::resetView() {
+    m_Total = viewCount();
+    m_ResetPending = true;
+    markDirty(0, INT_MAX);
+    scheduleRefresh();
+}
+/**
+* @brief 按测量结果计算合适的每页条数, 需要调整时在下一帧应用
+*/
+void PageTable::tunePageSize() {
+    if (!m_Adaptive || m_DisplayMode != Paged || m_RowCost <= 0) {
+        return;
+    }
+    // 分页栏耗时与每页条数无关, 剩余的目标时间留给整页渲染; 至少保证下限
+    double budget = m_LatencyTarget - m_PagerCost;
+    int size = budget > 0 ? int(qMin(budget / m_RowCost, double(m_MaxPageSize))) : m_MinPageSize;
+    size = qBound(m_MinPageSize, size, m_MaxPageSize);
+    // 偏差不足 20% 时保持, 避免测量抖动导致每页条数来回变化
+    if (qAbs(size - m_PageSize) * 5 < m_PageSize) {
+        m_PendingPageSize = 0;
+        return;
+    }
+    m_PendingPageSize = size;
+    scheduleRefresh();
+}
+/**
+* @brief 应用新的每页条数
+* @param pageSize 每页条数
+* @return 保持原当前页首行可见的新页码
+*/
+int PageTable::applyPageSize(int pageSize) {
+    int firstRow = (m_CurrentPage - 1) * m_PageSize;
+    m_PageSize = pageSize;
+    m_TableWidget->setRowCount(pageSize);
+    int page = firstRow / pageSize + 1;
+
+    // 调整不是用户翻页, 不计入翻页方式; 预取的页按原条数划分, 全部作废
+    m_NavPage = page;
+    m_PrefetchPages.clear();
+    markDirty(0, INT_MAX);
+    emit pageSizeChanged(pageSize);
+    return page;
+}
+/**
+* @brief 按最近的翻页方式计算需要预取的页码, 近的在前
+*/
+QList<int> PageTable::prefetchTargets() const {
+    QList<int> pages;
+    if (!m_Adaptive || m_MaxPrefetch <= 0) {
+        return pages;
+    }
+    // 连续逐页翻页时沿该方向预取, 次数越多越深; 跳页后前后各预取一页
+    int depth = qMin(qMax(1, qAbs(m_NavRun)), m_MaxPrefetch);
+    for (int k = 1; k <= depth; k++) {
+        if (m_NavRun >= 0) {
+            pages.append(m_CurrentPage + k);
+        }
+        if (m_NavRun <= 0) {
+            pages.append(m_CurrentPage - k);
+        }
+        if (m_NavRun == 0) {
+            break;
+        }
+    }
+    return pages;
+}
+
+/**
+* @brief 分片整理数据存储, 每次不超过单帧时间预算, 未完成时稍后继续
+*/
+void PageTable::compactStorage() {
+    // 用户正在操作时推迟整理
+    if (m_InputClock.isValid() && m_InputClock.elapsed() < 200) {
+        m_CompactTimer->start(200);
+        return;
+    }
+    int budget = m_FrameBudget > 0 ? m_FrameBudget : 8;
+    // 搜索索引的倒排表按上一次回收的映射分片改写, 与数据整理分帧进行
+    if (m_SearchIndex.remapPending()) {
+        m_SearchIndex.remapStep(budget);
+        m_CompactTimer->start(qMax(m_FrameInterval, 16));
+        return;
+    }
+    if (m_Data.compactStep(budget)) {
+        m_CompactTimer->start(qMax(m_FrameInterval, 16));
+        return;
+    }
+    // 墓碑槽位过多时重新编号; 新旧槽位号先后顺序一致, 排序索引和搜索结果按映射原地更新,
+    // 数据块的记录头和搜索索引的倒排表之后分片改写
+    if (m_Data.needsSlotReclaim()) {
+        const QVector<quint32> remap = m_Data.reclaimSlots();
+        m_OrderedIndex.remap(remap);
+        m_SearchIndex.remap(remap);
+        for (quint32 &slot : m_SearchResults) {
+            slot = remap.at(int(slot));
+        }
+        m_CompactTimer->start(qMax(m_FrameInterval, 16));
+    }
+}
+/**
+* @brief 有失效记录、待改写的数据块或过多的墓碑槽位时, 安排空闲时整理
+*/
+void PageTable::scheduleCompaction() {
+    if (!m_CompactTimer->isActive() && (m_Data.needsCompaction() || m_Data.needsSlotReclaim())) {
+        m_CompactTimer->start(200);
+    }
+}
+/**
+* @brief 分片压缩一段时间内未被访问的数据块, 用户正在操作时跳过
+*/
+void PageTable::compressColdBlocks() {
+    if (m_InputClock.isValid() && m_InputClock.elapsed() < 200) {
+        return;
+    }
+    // 预算用尽时下一帧继续, 否则等待下一个周期
+    if (m_Data.compressStep(m_FrameBudget > 0 ? m_FrameBudget : 8)) {
+        QTimer::singleShot(qMax(m_FrameInterval, 16), this, &PageTable::compressColdBlocks);
+    }
+}
+/**
+* @brief 空闲时预取一页相邻页, 未预取完时稍后继续
+*/
+void PageTable::prefetchPages() {
+    if (!m_Adaptive || m_DisplayMode != Paged) {
+        return;
+    }
+    // 用户正在操作或当前页尚未刷新完时推迟
+    if ((m_InputClock.isValid() && m_InputClock.elapsed() < 200) || m_RenderRow >= 0) {
+        m_PrefetchTimer->start(200);
+        return;
+    }
+    // 每次只预取一页, 单次耗时与翻页相当, 不会长时间阻塞界面
+    const QList<int> targets = prefetchTargets();
+    for (int page : targets) {
+        if (page < 1 || page > m_PageCount || m_PrefetchPages.contains(page)) {
+            continue;
+        }
+        m_PrefetchPages.insert(page, viewRows((page - 1) * m_PageSize, m_PageSize, visibleColumns()));
+        m_PrefetchTimer->start(qMax(m_FrameInterval, 16));
+        return;
+    }
+}
+
+/**
+* @brief 写入接入服务解析出的数据批次
+* @param batch 数据批次
+*/
+void PageTable::applyFeedBatch(const FeedProtocol::Batch &batch) {
+    Operation operation = Operation(batch.operation);
+    if (operation == Modify && batch.index < 0) {
+        qWarning() << "PageTable feed: 修改操作必须传入显式有效的index, 已忽略" << batch.rows.size() << "行";
+    } else {
+        applyUpdate(batch.rows, operation, batch.index);
+    }
+    // 通知接入服务该批次已处理, 在途批次低于上限时恢复读取
+    if (m_FeedServer) {
+        QMetaObject::invokeMethod(m_FeedServer, "batchApplied", Qt::QueuedConnection);
     }
 }
 
@@ -291,6 +1613,18 @@ void PageTable::loadTable(int pageIndex) {
 */
 bool PageTable::eventFilter(QObject *watched, QEvent *e){
 
+    // 记录用户输入时间, 刷新调度据此让出帧, 保证交互优先
+    switch (e->type()) {
+    case QEvent::MouseButtonPress:
+    case QEvent::MouseButtonRelease:
+    case QEvent::KeyPress:
+    case QEvent::Wheel:
+        m_InputClock.restart();
+        break;
+    default:
+        break;
+    }
+
     if (e->type() == QEvent::MouseButtonRelease){
         int newPage =-1;
         int currentPage = m_CurrentPage;
@@ -341,11 +1675,18 @@ bool PageTable::eventFilter(QObject *watched, QEvent *e){
 /************************** PO方法 ****************************/
 // 构造
 PageTable::PageTable(QStringList header, QList<QStringList> data, int pageSize, int middleBtnCount, QWidget *parent)
-    : QWidget(parent), m_PageSize(pageSize), m_MiddleBtnCount(middleBtnCount), m_Data(data) {
+    : QWidget(parent), m_PageSize(pageSize), m_MiddleBtnCount(middleBtnCount), m_Data(data), m_DisplayMode(Paged), m_SyncingScroll(false),
+      m_OrderedActive(false), m_OrderColumn(0), m_SortOrder(Qt::DescendingOrder), m_OrderLimit(0),
+      m_HiddenStorage(RowStore::Inline), m_SearchIndexed(false), m_SearchActive(false), m_GroupActive(false), m_GroupPending(0), m_GroupGeneration(0),
+      m_FrameInterval(33), m_FrameBudget(8), m_DeferredFrames(0), m_PagerDirty(false), m_ResetPending(false),
+      m_DirtyFirst(INT_MAX), m_DirtyLast(-1), m_RenderRow(-1),
+      m_Adaptive(false), m_LatencyTarget(30), m_MinPageSize(10), m_MaxPageSize(200), m_MaxPrefetch(3), m_PendingPageSize(0),
+      m_RowCost(0), m_PagerCost(0), m_NavPage(1), m_NavRun(0), m_PrefetchHits(0), m_PrefetchMisses(0),
+      m_AsyncQueue(new AsyncQueue()) {
     // 初始化基础信息
     m_CurrentPage = 1;
     m_PageBtnCount = m_MiddleBtnCount+2;
-    m_Total = m_Data.isEmpty() ? m_PageSize : m_Data.size();
+    m_Total = m_Data.size() == 0 ? m_PageSize : m_Data.size();
     // 全局字体
     m_Font = QFont("阿里巴巴普惠体 2.0 55 Regular", 10);
 
@@ -356,6 +1697,9 @@ PageTable::PageTable(QStringList header, QList<QStringList> data, int pageSize,
             header<<QString("默认列%1").arg(i);
         }
     }
+    m_TableHeader = header;
+    m_ViewHeader = header;
+    QString headerQSS = "QHeaderView::section { color: black; font: bold 18px '阿里巴巴普惠体 2.0 55 Regular'; text-align: center; height: 25px; background-color: #d1dff0; border: 1px solid #8faac9; border-left: none; }";
     m_TableWidget = new QTableWidget(m_PageSize, header.size());// 根据数据行和表头列初始化一个表格
     m_TableWidget->setSelectionMode(QAbstractItemView::SingleSelection);// 设置表格为单行选择
     m_TableWidget->setSelectionBehavior(QAbstractItemView::SelectRows);// 设置只能选中行，不能单个选择单元格
@@ -363,10 +1707,30 @@ PageTable::PageTable(QStringList header, QList<QStringList> data, int pageSize,
     m_TableWidget->verticalHeader()->setHidden(true);// 隐藏行号 (不显示表格左边的行号)
     m_TableWidget->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);// 让表格挤满占个父容器
     m_TableWidget->setHorizontalHeaderLabels(header);// 设置表头文本及样式
-    m_TableWidget->setStyleSheet("QHeaderView::section { color: black; font: bold 18px '阿里巴巴普惠体 2.0 55 Regular'; text-align: center; height: 25px; background-color: #d1dff0; border: 1px solid #8faac9; border-left: none; }");
+    m_TableWidget->setStyleSheet(headerQSS);
+
+    // 滚动模式视图, 默认隐藏; 样式与分页表格一致
+    m_Model = new PageTableModel(this, this);
+    m_TableView = new QTableView(this);
+    m_TableView->setModel(m_Model);
+    m_TableView->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_TableView->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_TableView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_TableView->setVerticalScrollMode(QAbstractItemView::ScrollPerItem);
+    m_TableView->verticalHeader()->setHidden(true);
+    // 固定行高, 视图无需逐行测量即可定位任意行, 只绘制视口内的行
+    m_TableView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    m_TableView->verticalHeader()->setDefaultSectionSize(m_TableWidget->verticalHeader()->defaultSectionSize());
+    m_TableView->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    m_TableView->setStyleSheet(headerQSS);
+    m_TableView->hide();
+    // 监听表格上的用户输入, 供刷新调度判断交互优先
+    m_TableWidget->viewport()->installEventFilter(this);
+    m_TableView->viewport()->installEventFilter(this);
 
     // 挂载部件
     m_RootLayout->addWidget(m_TableWidget);
+    m_RootLayout->addWidget(m_TableView);
 
 
     /************************** 初始化导航栏控件 ****************************/
@@ -436,12 +1800,31 @@ PageTable::PageTable(QStringList header, QList<QStringList> data, int pageSize,
 
     // 挂载信号
     connect(this, &PageTable::currentPageChanged, this, &PageTable::loadTable);
+    connect(m_TableView->verticalScrollBar(), &QScrollBar::valueChanged, this, &PageTable::syncPageWithScroll);
+
+    // 刷新调度定时器, 单次触发, 每帧按需重新启动
+    m_RefreshTimer = new QTimer(this);
+    m_RefreshTimer->setSingleShot(true);
+    connect(m_RefreshTimer, &QTimer::timeout, this, &PageTable::refreshFrame);
+    m_CompactTimer = new QTimer(this);
+    m_CompactTimer->setSingleShot(true);
+    connect(m_CompactTimer, &QTimer::timeout, this, &PageTable::compactStorage);
+    m_ColdTimer = new QTimer(this);
+    connect(m_ColdTimer, &QTimer::timeout, this, &PageTable::compressColdBlocks);
+    m_PrefetchTimer = new QTimer(this);
+    m_PrefetchTimer->setSingleShot(true);
+    connect(m_PrefetchTimer, &QTimer::timeout, this, &PageTable::prefetchPages);
+    m_FeedThread = nullptr;
+    m_FeedServer = nullptr;
+    qRegisterMetaType<PageTable::ChangeBatch>("PageTable::ChangeBatch");
 
     // 构造完后执行初始化, 加载第一页
     initialize();
+    setCurrentPage(m_CurrentPage);
 }
 
 PageTable::~PageTable() {
+    closeFeed();
     delete m_VisibleBtnList;
     delete m_TableWidget;
 
@@ -459,6 +1842,21 @@ PageTable::~PageTable() {
 
 // Getters && Setters
 void PageTable::setCurrentPage(int page){
+    QElapsedTimer clock;
+    clock.start();
+    refreshPager(page);
+    if (m_Adaptive) {
+        double sample = clock.nsecsElapsed() / 1e6;
+        m_PagerCost = m_PagerCost > 0 ? m_PagerCost * 0.7 + sample * 0.3 : sample;
+    }
+    // 发送当前页数已更改的信号
+    emit currentPageChanged(page);
+}
+/**
+* @brief 刷新分页栏状态: 当前页、页码按钮文本、省略号及上下页按钮
+* @param page 目标页码
+*/
+void PageTable::refreshPager(int page){
 
     // 更新当前页 & 输入框数据
     // 如果页数小于1, 将其设置为1; 如果大于总页数, 将其设置为总页数；否则保持不变
@@ -508,10 +1906,6 @@ void PageTable::setCurrentPage(int page){
         m_NextBtn->setCursor(Qt::ForbiddenCursor);
         m_NextBtn->setToolTip("已是最后一页.");
     }
-
-    // 发送当前页数已更改的信号
-    emit currentPageChanged(page);
-
 }
 void PageTable::setPageCount(int pageCount){
     m_PageCount = pageCount;
@@ -519,7 +1913,7 @@ void PageTable::setPageCount(int pageCount){
 
 
 QList<QStringList> PageTable::Data() const {
-    return m_Data;
+    return m_Data.toList();
 }
 int PageTable::Total() const {
     return m_Total;
@@ -533,3 +1927,10 @@ int PageTable::CurrentPage() const {
 int PageTable::PageSize() const {
     return m_PageSize;
 }
+PageTable::DisplayMode PageTable::Mode() const {
+    return m_DisplayMode;
+}
+bool PageTable::GroupReady() const {
+    // 分组视图的分段统计是否已全部合并
+    return !m_GroupActive || m_GroupPending == 0;
+}
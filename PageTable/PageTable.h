@@ -3,13 +3,30 @@
 
 #include <QLabel>
 #include <QEvent>
+#include <QTimer>
+#include <QFuture>
+#include <QSharedPointer>
+#include <QBitArray>
 #include <QWidget>
 #include <QLineEdit>
 #include <QPushButton>
 #include <QHBoxLayout>
+#include <QSet>
+#include <QHash>
 #include <QVBoxLayout>
+#include <QTableView>
 #include <QTableWidget>
 #include <QButtonGroup>
+#include <QElapsedTimer>
+#include "RowStore.h"
+#include "FeedProtocol.h"
+#include "OrderedIndex.h"
+#include "TrigramIndex.h"
+#include "GroupSummary.h"
+
+class QThread;
+class FeedServer;
+class PageTableModel;
 
 /**
  * @author : LMH
@@ -30,6 +47,68 @@ public:
     };
     Q_ENUM(Operation)
 
+    /**
+     * @brief 显示模式枚举: 分页、连续滚动
+     */
+    enum DisplayMode {
+        Paged = 0,
+        Scroll = 1
+    };
+    Q_ENUM(DisplayMode)
+
+    /**
+     * @brief 导出格式枚举: CSV、二进制(与数据接入的帧格式相同)
+     */
+    enum ExportFormat {
+        Csv = 0,
+        Binary = 1
+    };
+    Q_ENUM(ExportFormat)
+
+    /**
+     * @brief 异步更新数据的结果
+     */
+    struct UpdateResult {
+        int rowsAffected = 0;   // 受影响的行数, 删除时为实际删除的行数
+        int total = 0;          // 更新后的总条数
+        QStringList errors;     // 错误信息, 为空表示成功
+    };
+
+    /**
+     * @brief 自适应分页的测量结果和决策, 用于观察调整过程
+     */
+    struct PagingStats {
+        bool adaptive = false;      // 是否启用自适应分页
+        int targetMs = 0;           // 翻页延迟目标(毫秒)
+        int pageSize = 0;           // 当前每页条数
+        double rowCostMs = 0;       // 每行渲染耗时(毫秒), 指数平滑
+        double pagerCostMs = 0;     // 分页栏刷新耗时(毫秒), 指数平滑
+        int prefetchDepth = 0;      // 预取的相邻页数
+        int prefetchDirection = 0;  // 预取方向: 1 向后, -1 向前, 0 前后各一页
+        int cachedPages = 0;        // 已预取的页数
+        int prefetchHits = 0;       // 翻页命中预取的次数
+        int prefetchMisses = 0;     // 翻页未命中预取的次数
+    };
+
+    /**
+     * @brief 数据变更, 行索引按写入顺序(即 Data() 的顺序)计算
+     */
+    struct RowChange {
+        enum Kind {
+            Inserted = 0,   // 在 first 处插入 count 行
+            Updated = 1,    // first 起的 count 行被修改
+            Removed = 2     // 删除 first 起的 count 行
+        };
+        Kind kind = Inserted;
+        int first = 0;
+        int count = 0;
+        QBitArray columns;  // 修改时取值变化的列, 位索引即列索引; 其余类型为空
+    };
+    /**
+     * @brief 一批数据变更, 须按顺序应用, 每项的行索引是应用之前各项之后的位置
+     */
+    typedef QVector<RowChange> ChangeBatch;
+
     /**
      * @brief 创建一个由布局对象包装的组件, 参数同构造, 提供默认值
      * @param header 表头
@@ -55,16 +134,218 @@ public:
      * - 删除: 删除总数据中与传入数据匹配的所有数据。
      *
      * 注意：修改操作是基于index索引位置进行的。
-     *      该方法在更新数据后会重新初始化分页信息和显示分页控件。
+     *      该方法只更新数据, 分页信息和表格由刷新调度在下一帧合并刷新。
+     *      此前提交的 updateDataAsync 先按提交顺序写入, 尚未准备完成的在此等待或直接准备,
+     *      保证同步与异步更新的写入顺序与调用顺序一致。
      */
     void updateData(QList<QStringList> &data, Operation operation=Operation::Append, int index=-1);
 
+    /**
+     * @brief 异步更新数据
+     * @param data 数据集合
+     * @param operation 数据操作类型, 同 updateData
+     * @param index 起始位置, 用于修改操作, 同 updateData
+     * @return 更新结果的 QFuture, 包括受影响行数、更新后的总条数和错误信息
+     *
+     * 校验、去重等准备工作在线程池中执行, 准备完成后回到组件所在线程写入数据;
+     * 错误以结果值返回, 不弹出模态对话框, 可在非 GUI 线程调用。
+     * 每次调用在提交时编号, 准备先完成的更新等待之前提交的更新写入后再写入, 写入顺序与调用顺序一致。
+     *
+     * 注意: 写入本身仍在组件所在线程执行, 包括记录编码、字典登记、视图索引同步和删除时的逐行比较,
+     *      耗时与同步的 updateData 相同。这些步骤依赖存储的当前状态(字典、槽位和此前的更新),
+     *      无法在快照上提前完成; 异步接口只让调用方不必等待, 并不减少界面线程的工作量。
+     */
+    QFuture<UpdateResult> updateDataAsync(const QList<QStringList> &data, Operation operation=Operation::Append, int index=-1);
+
     /**
      * @brief 获取当前页数据
      * @return 当前页数据
      */
     QList<QStringList> getCurrentPageData();
 
+    /**
+     * @brief 切换显示模式
+     * @param mode 显示模式, 枚举定义, 包括分页和连续滚动
+     *
+     * 滚动模式使用固定行高的虚拟滚动视图, 只渲染视口内的行, 与数据总量无关;
+     * 两种模式共用同一份数据和更新方法, 分页栏的当前页与滚动位置保持同步,
+     * 点击页码会滚动到该页的首行。
+     */
+    void setDisplayMode(DisplayMode mode);
+
+    /**
+     * @brief 设置是否对低基数列启用字典编码, 默认启用
+     * @param enabled 是否启用; 关闭时已编码的列全部还原为字符串存储
+     *
+     * 启用时根据列的取值统计自动选择: 重复取值多的列(状态、代码、单位等)
+     * 每个单元格只保存一个 16 位编码, 显示时才查字典还原。
+     */
+    void setDictionaryEncoding(bool enabled);
+
+    /**
+     * @brief 按指定列排序显示, 数据更新时增量维护排序
+     * @param column 排序列索引
+     * @param order 排序方向, 默认降序, 即取值最大的行在前
+     * @param limit 只显示排名前 limit 的行, 小于等于 0 表示显示全部
+     *
+     * 排序由顺序统计树维护: 追加、修改、删除每行只需 O(log n) 调整, 不重新排序;
+     * 翻页按名次定位, 取一页为 O(log n + 每页条数), 与数据总量基本无关。
+     * 能解析为数值的取值按数值比较, 其余按字符串比较; 取值相同的行保持写入顺序。
+     * 排序视图下修改操作的 index 仍按写入顺序计算, 分页、滚动和导出均按排序后的顺序。
+     */
+    void setOrderedView(int column, Qt::SortOrder order=Qt::DescendingOrder, int limit=0);
+    /**
+     * @brief 取消排序视图, 恢复按写入顺序显示
+     */
+    void clearOrderedView();
+
+    /**
+     * @brief 设置是否维护子串搜索索引
+     * @param enabled 是否启用; 关闭时释放索引
+     * @param columns 参与搜索的列, 为空表示全部列
+     *
+     * 启用后数据的追加、修改、删除同步更新三元组倒排索引, 搜索只需对倒排表求交集并校验候选行,
+     * 不再逐行扫描; 索引的内存占用通过 searchIndexStats 查看。
+     */
+    void setSearchIndex(bool enabled, const QList<int> &columns=QList<int>());
+    /**
+     * @brief 搜索包含指定文本的行, 忽略大小写, 结果按写入顺序分页显示
+     * @param text 搜索文本, 为空时取消搜索
+     *
+     * 未启用索引或文本少于 3 个字符时逐行扫描。搜索期间数据更新会同步到结果中;
+     * 搜索结果优先于排序视图显示, 取消搜索后恢复排序视图。
+     */
+    void search(const QString &text);
+    /**
+     * @brief 取消搜索, 恢复显示全部行
+     */
+    void clearSearch();
+    /**
+     * @brief 切换为分组汇总视图
+     * @param groupColumn 分组列, 小于 0 时取消分组
+     * @param aggregate 汇总方式, 枚举定义, 包括行数、合计和平均值
+     * @param valueColumn 汇总列, 行数汇总时忽略
+     * @param pivotColumn 透视列, 其每个取值展开为一列, 小于 0 表示不透视
+     *
+     * 首次统计取数据快照, 按线程数分段在线程池中并行统计后合并, 分段完成一个合并一个;
+     * 统计期间及之后的数据更新直接增减对应分组, 不重新统计。分组行按分组取值排序,
+     * 通过分页栏翻页, 表头随汇总方式和透视取值变化; 分组视图优先于搜索和排序视图。
+     */
+    void setGroupView(int groupColumn, GroupSummary::Aggregate aggregate=GroupSummary::Count, int valueColumn=-1, int pivotColumn=-1);
+    /**
+     * @brief 取消分组汇总视图, 恢复显示明细行
+     */
+    void clearGroupView();
+
+    /**
+     * @brief 获取搜索索引的规模统计
+     * @return 统计信息, 包括三元组数量、倒排表条目数和内存占用
+     */
+    TrigramIndex::Stats searchIndexStats() const;
+
+    /**
+     * @brief 设置列是否显示
+     * @param column 列索引
+     * @param visible 是否显示
+     *
+     * 隐藏的列在刷新表格时既不解码也不比较, 列越少刷新越快; 配合 setHiddenColumnStorage
+     * 可以把隐藏列移出内存。隐藏只影响明细显示, 导出、搜索和 Data() 仍包含全部列。
+     */
+    void setColumnVisible(int column, bool visible);
+    /**
+     * @brief 指定列是否显示
+     */
+    bool isColumnVisible(int column) const;
+    /**
+     * @brief 设置隐藏列的存储方式, 对已隐藏和之后隐藏的列生效
+     * @param storage 存储方式, 枚举定义, 包括常驻内存(默认)、丢弃和溢出到临时文件
+     *
+     * 丢弃的列不再保存取值, 再次显示时已有行的该列为空; 溢出的列写入临时文件,
+     * 再次显示时读回内存。切换存储方式后新记录立即按新方式写入, 已有记录在空闲时分片改写。
+     */
+    void setHiddenColumnStorage(RowStore::ColumnStorage storage);
+
+    /**
+     * @brief 在后台线程导出当前视图的数据
+     * @param path 文件路径, 写入完成后才替换目标文件
+     * @param format 导出格式, 枚举定义, 包括 CSV 和二进制
+     * @return 导出是否成功的 QFuture
+     *
+     * 调用时对数据和当前视图取隐式共享的快照, 之后的更新不影响导出内容;
+     * 视图的行在工作线程中按块取出、解码并写出, 导出本身的内存占用与总行数无关。进度和结果通过 exportProgress、exportFinished 信号通知。
+     *
+     * 注意: 取快照只增加引用计数, 但导出期间的第一次更新会让组件与快照分离, 在界面线程中整体复制
+     *      存储的槽位表和行顺序(每行 16 字节)、被写入的数据块, 以及正在导出的视图:
+     *      排序视图的索引(每行一个含排序键的节点)、搜索结果(每行 4 字节)或分组汇总。
+     *      导出大表时应避免同时高频更新, 或在导出完成后再写入。
+     */
+    QFuture<bool> exportTo(const QString &path, ExportFormat format=ExportFormat::Csv);
+
+    /**
+     * @brief 开始在本地套接字上接收生产者进程发送的数据
+     * @param name 本地服务名, 生产者以此名称连接
+     * @return 是否监听成功
+     *
+     * 数据帧格式见 FeedProtocol, 每帧是一批追加、修改或删除的行;
+     * 帧在独立线程中解析, 解析完成后写入数据并由刷新调度合并刷新。
+     * 尚未写入的批次达到 FeedServer::MaxInFlight 时暂停读取, 生产者写满系统缓冲后随之阻塞, 积压不会无限增长。
+     * 名称已被其他正在运行的服务占用时返回 false, 不会删除对方的套接字文件。
+     */
+    bool listenFeed(const QString &name);
+    /**
+     * @brief 停止接收数据并断开所有生产者连接
+     */
+    void closeFeed();
+
+    /**
+     * @brief 获取数据存储的内存占用统计
+     * @return 统计信息, 包括数据块、存活/失效字节、行索引和字典的占用
+     *
+     * 删除和修改留下的失效记录由空闲时的分片整理回收, 整理完成后整块释放; 统计按数据块估算,
+     * 不等于进程的常驻内存, 释放的内存是否立即归还系统取决于 malloc 的实现。
+     */
+    RowStore::MemoryStats memoryStats() const;
+
+    /**
+     * @brief 设置冷块压缩
+     * @param enabled 是否启用, 默认关闭; 关闭时全部数据块解压还原
+     * @param cacheBlocks 解压缓存最多保留的块数, 每块约 1MB; 越大翻页越快, 占用内存越多
+     * @param level 压缩级别, 1 最快, 9 压缩率最高
+     *
+     * 启用后空闲时每秒检查一次, 上一周期内没有被翻页、导出等访问过的数据块被压缩;
+     * 访问已压缩的块时按需解压到缓存。压缩节省的内存见 memoryStats 的 savedBytes。
+     */
+    void setColdCompression(bool enabled, int cacheBlocks=4, int level=1);
+
+    /**
+     * @brief 设置刷新调度参数
+     * @param maxFps 最大刷新帧率, 两次刷新之间至少间隔 1000/maxFps 毫秒; 小于等于 0 表示不限制
+     * @param frameBudgetMs 单帧时间预算(毫秒), 超出后剩余的单元格顺延到下一帧; 小于等于 0 表示不限制
+     *
+     * updateData 可以任意频率调用, 两帧之间的变更会被合并, 每帧只刷新一次分页栏和当前页;
+     * 用户正在操作时调度会让出帧, 保证点击和输入优先响应。默认 30 帧/秒, 单帧 8 毫秒。
+     */
+    void setRefreshRate(int maxFps, int frameBudgetMs);
+
+    /**
+     * @brief 设置自适应分页
+     * @param enabled 是否启用, 默认关闭; 关闭时保持当前每页条数并释放预取的页
+     * @param targetMs 翻页延迟目标(毫秒), 包括分页栏刷新和整页渲染
+     * @param minPageSize 每页条数下限
+     * @param maxPageSize 每页条数上限
+     * @param maxPrefetch 最多预取的相邻页数, 0 表示不预取
+     *
+     * 启用后每次翻页测量分页栏刷新和整页渲染的耗时, 按 (目标 - 分页栏耗时) / 每行耗时
+     * 调整每页条数, 偏差不足 20% 时保持不变; 调整后当前页首行保持可见。
+     * 空闲时按最近的翻页方式预取相邻页: 连续向后或向前翻页时沿该方向预取, 连续次数越多
+     * 预取越深; 跳页后只预取前后各一页。数据变更时作废受影响的预取页。
+     */
+    void setAdaptivePaging(bool enabled, int targetMs=30, int minPageSize=10, int maxPageSize=200, int maxPrefetch=3);
+    /**
+     * @brief 获取自适应分页的测量结果和决策
+     */
+    PagingStats pagingStats() const;
+
     // 构造
     explicit PageTable(QStringList header=QStringList(), QList<QStringList> data=QList<QStringList>(), int pageSize=25, int middleBtnCount=10, QWidget *parent = nullptr);
     ~PageTable();
@@ -74,6 +355,8 @@ public:
     int PageCount() const;
     int Total() const;
     QList<QStringList> Data() const;
+    DisplayMode Mode() const;
+    bool GroupReady() const;
 
 signals:
     /**
@@ -81,6 +364,34 @@ signals:
      * @param page 当前页码
      */
     void currentPageChanged(int page);
+    /**
+     * @brief 导出进度变化时发射此信号, 频率受限
+     * @param path 导出文件路径
+     * @param written 已写入行数
+     * @param total 总行数
+     */
+    void exportProgress(const QString &path, qint64 written, qint64 total);
+    /**
+     * @brief 导出结束时发射此信号
+     * @param path 导出文件路径
+     * @param ok 是否成功
+     * @param error 失败时的错误信息
+     */
+    void exportFinished(const QString &path, bool ok, const QString &error);
+    /**
+     * @brief 数据变更时发射此信号, 两帧之间的变更合并为一批
+     * @param changes 变更批次, 按顺序应用即可把上一批之后的数据同步到最新
+     * @param total 应用后的总行数, 可用于校验
+     *
+     * 只有连接了此信号才会记录变更。需要在其他线程处理时, 将接收对象移到该线程并使用
+     * 默认或队列连接, 批次会在接收对象所在线程投递。
+     */
+    void dataChanged(const PageTable::ChangeBatch &changes, int total);
+    /**
+     * @brief 自适应分页调整每页条数后发射此信号
+     * @param pageSize 新的每页条数
+     */
+    void pageSizeChanged(int pageSize);
 
 protected:
     /**
@@ -118,9 +429,9 @@ private:
      */
     int m_Total;
     /**
-     * @brief 数据集
+     * @brief 数据集, 按列存储, 低基数列自动字典编码
      */
-    QList<QStringList> m_Data;
+    RowStore m_Data;
 
     /**
      * @brief 根布局
@@ -139,7 +450,234 @@ private:
      * @brief 表头配置
      */
     QStringList m_TableHeader;
+    /**
+     * @brief 当前显示的表头, 分组视图下为汇总表的表头
+     */
+    QStringList m_ViewHeader;
+    /**
+     * @brief 隐藏的列
+     */
+    QSet<int> m_HiddenColumns;
+    /**
+     * @brief 隐藏列的存储方式
+     */
+    RowStore::ColumnStorage m_HiddenStorage;
+    /**
+     * @brief 显示模式
+     */
+    DisplayMode m_DisplayMode;
+    /**
+     * @brief 滚动模式下的表格视图
+     */
+    QTableView* m_TableView;
+    /**
+     * @brief 滚动模式下的数据模型
+     */
+    PageTableModel* m_Model;
+    /**
+     * @brief 是否正在由程序滚动视图, 此时不反向同步页码
+     */
+    bool m_SyncingScroll;
+
+    /**************** 刷新调度 ******************/
+    /**
+     * @brief 刷新定时器, 单次触发
+     */
+    QTimer* m_RefreshTimer;
+    /**
+     * @brief 距上一帧开始的计时
+     */
+    QElapsedTimer m_FrameClock;
+    /**
+     * @brief 距上次用户输入的计时
+     */
+    QElapsedTimer m_InputClock;
+    /**
+     * @brief 两帧之间的最小间隔(毫秒)
+     */
+    int m_FrameInterval;
+    /**
+     * @brief 单帧时间预算(毫秒)
+     */
+    int m_FrameBudget;
+    /**
+     * @brief 因用户输入连续让出的帧数
+     */
+    int m_DeferredFrames;
+    /**
+     * @brief 是否有待刷新的数据变更
+     */
+    bool m_PagerDirty;
+    /**
+     * @brief 滚动模式的模型是否需要整体重载
+     */
+    bool m_ResetPending;
+    /**
+     * @brief 两帧之间合并的变更区间起始行
+     */
+    int m_DirtyFirst;
+    /**
+     * @brief 两帧之间合并的变更区间结束行(包含)
+     */
+    int m_DirtyLast;
+    /**
+     * @brief 当前页下一个待刷新的行, -1 表示已刷新完毕
+     */
+    int m_RenderRow;
+    /**
+     * @brief 存储整理定时器, 有失效记录时在空闲时分片整理
+     */
+    QTimer* m_CompactTimer;
+    /**
+     * @brief 冷块压缩定时器, 启用压缩时周期触发
+     */
+    QTimer* m_ColdTimer;
+    /**
+     * @brief 本帧待发出的数据变更
+     */
+    ChangeBatch m_PendingChanges;
+
+    /**************** 排序视图 ******************/
+    /**
+     * @brief 是否启用排序视图
+     */
+    bool m_OrderedActive;
+    /**
+     * @brief 排序列索引
+     */
+    int m_OrderColumn;
+    /**
+     * @brief 排序方向
+     */
+    Qt::SortOrder m_SortOrder;
+    /**
+     * @brief 只显示排名前若干行, 小于等于 0 表示全部
+     */
+    int m_OrderLimit;
+    /**
+     * @brief 排序列的顺序统计树
+     */
+    OrderedIndex m_OrderedIndex;
+    /**
+     * @brief 正在刷新的当前页数据, 分帧刷新期间复用
+     */
+    QList<QStringList> m_PageRows;
+
+    /**************** 搜索 ******************/
+    /**
+     * @brief 是否维护搜索索引
+     */
+    bool m_SearchIndexed;
+    /**
+     * @brief 子串搜索索引
+     */
+    TrigramIndex m_SearchIndex;
+    /**
+     * @brief 是否正在显示搜索结果
+     */
+    bool m_SearchActive;
+    /**
+     * @brief 搜索文本
+     */
+    QString m_SearchText;
+    /**
+     * @brief 搜索结果的槽位号, 升序即写入顺序
+     */
+    QVector<quint32> m_SearchResults;
+
+    /**************** 分组汇总 ******************/
+    /**
+     * @brief 是否显示分组汇总
+     */
+    bool m_GroupActive;
+    /**
+     * @brief 分组汇总结果, 含统计期间的增量
+     */
+    GroupSummary m_GroupSummary;
+    /**
+     * @brief 尚未合并的分段统计数量
+     */
+    int m_GroupPending;
+    /**
+     * @brief 分组视图的版本号, 切换后丢弃旧版本的分段结果
+     */
+    int m_GroupGeneration;
 
+    /**************** 自适应分页 ******************/
+    /**
+     * @brief 是否启用自适应分页
+     */
+    bool m_Adaptive;
+    /**
+     * @brief 翻页延迟目标(毫秒)
+     */
+    int m_LatencyTarget;
+    /**
+     * @brief 每页条数下限
+     */
+    int m_MinPageSize;
+    /**
+     * @brief 每页条数上限
+     */
+    int m_MaxPageSize;
+    /**
+     * @brief 最多预取的相邻页数
+     */
+    int m_MaxPrefetch;
+    /**
+     * @brief 待应用的每页条数, 0 表示无需调整
+     */
+    int m_PendingPageSize;
+    /**
+     * @brief 每行渲染耗时(毫秒), 指数平滑
+     */
+    double m_RowCost;
+    /**
+     * @brief 分页栏刷新耗时(毫秒), 指数平滑
+     */
+    double m_PagerCost;
+    /**
+     * @brief 上一次加载的页码, 用于识别翻页方式
+     */
+    int m_NavPage;
+    /**
+     * @brief 连续逐页翻页的次数, 正数向后, 负数向前, 0 表示刚跳页
+     */
+    int m_NavRun;
+    /**
+     * @brief 翻页命中预取的次数
+     */
+    int m_PrefetchHits;
+    /**
+     * @brief 翻页未命中预取的次数
+     */
+    int m_PrefetchMisses;
+    /**
+     * @brief 预取的页数据, 以页码为键
+     */
+    QHash<int, QList<QStringList>> m_PrefetchPages;
+    /**
+     * @brief 预取定时器, 翻页后空闲时逐页预取
+     */
+    QTimer* m_PrefetchTimer;
+
+    /**************** 数据接入 ******************/
+    /**
+     * @brief 数据接入线程
+     */
+    QThread* m_FeedThread;
+    /**
+     * @brief 数据接入服务, 运行在接入线程
+     */
+    FeedServer* m_FeedServer;
+    /**
+     * @brief 异步更新的提交队列, 定义见实现文件
+     */
+    struct AsyncQueue;
+    /**
+     * @brief 异步更新的提交队列, 工作线程共同持有, 组件销毁后由仍在执行的工作线程释放
+     */
+    QSharedPointer<AsyncQueue> m_AsyncQueue;
 
     /**************** 导航栏元素 ******************/
     /**
@@ -209,6 +747,35 @@ private:
 
 
     /**************** 私有方法 ******************/
+    /**
+     * @brief 写入数据变更并请求刷新, 调用前应已完成参数校验
+     * @param data 数据集合
+     * @param operation 数据操作类型
+     * @param index 起始位置, 用于修改操作
+     * @return 受影响的行数
+     */
+    int applyUpdate(const QList<QStringList> &data, Operation operation, int index);
+    /**
+     * @brief 按提交顺序写入已准备完成的异步更新
+     * @param wait 是否写入此前提交的全部更新, 为 false 时遇到未准备完成的更新即停止
+     */
+    void applyAsyncUpdates(bool wait);
+    /**
+     * @brief 校验并整理待更新的数据, 只依赖参数, 可在工作线程执行
+     * @param data 数据集合, 校验时可能被截断或去重
+     * @param operation 数据操作类型
+     * @param index 起始位置, 用于修改操作
+     * @return 错误信息, 为空表示校验通过
+     */
+    static QStringList prepareUpdate(QList<QStringList> &data, Operation operation, int index);
+    /**
+     * @brief 记录一项数据变更, 与上一项相邻且类型相同时合并
+     * @param kind 变更类型
+     * @param first 起始行, 按顺序应用之前各项变更后的行索引
+     * @param count 行数
+     * @param columns 修改的列, 仅用于修改
+     */
+    void recordChange(RowChange::Kind kind, int first, int count, const QBitArray &columns=QBitArray());
     /**
      * @brief 初始化方法, 用于设置分页信息和显示分页控件
      */
@@ -228,6 +795,118 @@ private:
      * @return 按钮集合
      */
     QList<QAbstractButton*> getButtons();
+    /**
+     * @brief 刷新分页栏状态: 当前页、页码按钮文本、省略号及上下页按钮
+     * @param page 目标页码
+     */
+    void refreshPager(int page);
+    /**
+     * @brief 请求在下一帧刷新; 两帧之间的多次请求合并为一次
+     */
+    void scheduleRefresh();
+    /**
+     * @brief 记录待刷新的数据区间, 与已有区间合并
+     * @param first 起始行
+     * @param last 结束行(包含)
+     */
+    void markDirty(int first, int last);
+    /**
+     * @brief 将合并后的数据变更通知给滚动模式的模型
+     */
+    void flushModel();
+    /**
+     * @brief 从 m_RenderRow 开始逐行刷新当前页的单元格, 只更新发生变化的单元格
+     * @param budgetMs 时间预算(毫秒), 超出时记录进度留待下一帧; 小于等于 0 表示不限制
+     * @return 当前页是否已全部刷新
+     */
+    bool renderRows(int budgetMs);
+    /**
+     * @brief 当前视图的行数; 排序视图受显示数量限制
+     */
+    int viewCount() const;
+    /**
+     * @brief 按视图顺序获取指定区间的行
+     * @param first 起始位置
+     * @param count 行数
+     * @param columns 只解码位为 1 的列, 为空表示全部列; 分组视图忽略
+     * @return 行数据集合
+     */
+    QList<QStringList> viewRows(int first, int count, const QBitArray &columns=QBitArray()) const;
+    /**
+     * @brief 按视图顺序获取单元格
+     * @param row 视图中的行位置
+     * @param column 列索引
+     * @return 单元格文本
+     */
+    QString viewCell(int row, int column) const;
+    /**
+     * @brief 是否有需要随数据变更同步的视图索引
+     */
+    bool hasRowIndexes() const;
+    /**
+     * @brief 同步视图索引: 新增一行
+     * @param slot 行的槽位号
+     * @param values 行数据
+     */
+    void rowInserted(quint32 slot, const QStringList &values);
+    /**
+     * @brief 同步视图索引: 移除一行
+     * @param slot 行的槽位号
+     * @param values 移除前的行数据
+     */
+    void rowRemoved(quint32 slot, const QStringList &values);
+    /**
+     * @brief 渲染时需要解码的列; 没有隐藏列或显示分组汇总时为空, 表示全部列
+     */
+    QBitArray visibleColumns() const;
+    /**
+     * @brief 将列的显示状态应用到分页表格和滚动视图; 分组视图的列与原始列不对应, 全部显示
+     */
+    void applyColumnVisibility();
+    /**
+     * @brief 按列的显示状态调整其存储方式: 隐藏的列按设置丢弃或溢出, 显示的列常驻内存
+     */
+    void applyColumnStorage(int column);
+    /**
+     * @brief 按当前存储的取值重建全部视图索引
+     */
+    void rebuildRowIndexes();
+    /**
+     * @brief 当前视图的表头
+     */
+    QStringList viewHeader() const;
+    /**
+     * @brief 表头变化时更新表格列和滚动模式的模型
+     */
+    void applyViewHeader();
+    /**
+     * @brief 合并一段分组统计结果
+     * @param partial 分段统计结果
+     * @param generation 统计开始时的分组视图版本号
+     */
+    void mergeGroupPartial(const GroupSummary &partial, int generation);
+    /**
+     * @brief 视图切换后重新计算总数并整体刷新, 当前页超出范围时由刷新调度调整
+     */
+    void resetView();
+    /**
+     * @brief 有失效记录、待改写的数据块或过多的墓碑槽位时, 安排空闲时整理
+     */
+    void scheduleCompaction();
+    /**
+     * @brief 按测量结果计算合适的每页条数, 需要调整时在下一帧应用
+     */
+    void tunePageSize();
+    /**
+     * @brief 应用新的每页条数
+     * @param pageSize 每页条数
+     * @return 保持原当前页首行可见的新页码
+     */
+    int applyPageSize(int pageSize);
+    /**
+     * @brief 按最近的翻页方式计算需要预取的页码, 近的在前
+     */
+    QList<int> prefetchTargets() const;
 
     // Private Setters
     void setCurrentPage(int page);
@@ -238,7 +917,35 @@ private slots:
      * @param pageIndex 页面索引
      */
     void loadTable(int pageIndex);
+    /**
+     * @brief 滚动模式下根据视口首行同步当前页
+     */
+    void syncPageWithScroll();
+    /**
+     * @brief 刷新调度的单帧处理: 合并期间的所有数据变更, 刷新分页栏和当前页
+     */
+    void refreshFrame();
+    /**
+     * @brief 分片整理数据存储, 每次不超过单帧时间预算, 未完成时稍后继续
+     */
+    void compactStorage();
+    /**
+     * @brief 分片压缩一段时间内未被访问的数据块, 用户正在操作时跳过
+     */
+    void compressColdBlocks();
+    /**
+     * @brief 空闲时预取一页相邻页, 未预取完时稍后继续
+     */
+    void prefetchPages();
+    /**
+     * @brief 写入接入服务解析出的数据批次
+     * @param batch 数据批次
+     */
+    void applyFeedBatch(const FeedProtocol::Batch &batch);
 
+    friend class PageTableModel;
 };
 
+Q_DECLARE_METATYPE(PageTable::ChangeBatch)
+
 #endif // PageTable_H
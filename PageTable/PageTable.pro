@@ -1,4 +1,4 @@
-QT       += core gui
+QT       += core gui network concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -9,14 +9,30 @@ CONFIG += c++17
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    FeedProtocol.cpp \
+    FeedServer.cpp \
+    GroupSummary.cpp \
     ObjectUtil.cpp \
+    OrderedIndex.cpp \
     PageTable.cpp \
+    PageTableModel.cpp \
+    RowStore.cpp \
+    TableExporter.cpp \
+    TrigramIndex.cpp \
     main.cpp \
     mainwindow.cpp
 
 HEADERS += \
+    FeedProtocol.h \
+    FeedServer.h \
+    GroupSummary.h \
     ObjectUtil.h \
+    OrderedIndex.h \
     PageTable.h \
+    PageTableModel.h \
+    RowStore.h \
+    TableExporter.h \
+    TrigramIndex.h \
     mainwindow.h
 
 FORMS += \
@@ -0,0 +1,74 @@
+#include "PageTableModel.h"
+
+#include "PageTable.h"
+
+PageTableModel::PageTableModel(PageTable *table, QObject *parent)
+    : QAbstractTableModel(parent), m_Table(table), m_RowCount(0) {
+}
+
+int PageTableModel::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : m_RowCount;
+}
+
+int PageTableModel::columnCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : m_Table->m_ViewHeader.size();
+}
+
+QVariant PageTableModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= m_RowCount || index.row() >= m_Table->viewCount()) {
+        return QVariant();
+    }
+
+    switch (role) {
+    case Qt::DisplayRole: {
+        // 与分页模式的单元格显示规则保持一致
+        const QString text = m_Table->viewCell(index.row(), index.column());
+        return text.isEmpty() || text == "nan" ? QString("--") : text;
+    }
+    case Qt::FontRole: return m_Table->m_Font;
+    case Qt::TextAlignmentRole: return int(Qt::AlignCenter);
+    default: return QVariant();
+    }
+}
+
+QVariant PageTableModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+        return m_Table->m_ViewHeader.value(section);
+    }
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+/**
+* @brief 通知模型数据集末尾追加了行
+* @param total 追加后的总行数
+*/
+void PageTableModel::rowsAppended(int total) {
+    if (total <= m_RowCount) {
+        return;
+    }
+    beginInsertRows(QModelIndex(), m_RowCount, total - 1);
+    m_RowCount = total;
+    endInsertRows();
+}
+
+/**
+* @brief 通知模型指定区间内的行被修改
+* @param first 起始行
+* @param last 结束行(包含)
+*/
+void PageTableModel::rowsChanged(int first, int last) {
+    last = qMin(last, m_RowCount - 1);
+    if (first < 0 || first > last) {
+        return;
+    }
+    emit dataChanged(index(first, 0), index(last, columnCount() - 1));
+}
+
+/**
+* @brief 重新加载整个模型, 用于删除等无法定位区间的操作
+*/
+void PageTableModel::reload() {
+    beginResetModel();
+    m_RowCount = m_Table->viewCount();
+    endResetModel();
+}
@@ -0,0 +1,52 @@
+#ifndef PAGETABLEMODEL_H
+#define PAGETABLEMODEL_H
+
+#include <QFont>
+#include <QAbstractTableModel>
+
+class PageTable;
+
+/**
+ * @author : LMH
+ * @date   : 2026.10.18
+ * @brief  : 分页组件滚动模式下的数据模型, 直接读取组件的数据集, 不复制数据
+ */
+class PageTableModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    explicit PageTableModel(PageTable *table, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    /**
+     * @brief 通知模型数据集末尾追加了行
+     * @param total 追加后的总行数
+     */
+    void rowsAppended(int total);
+    /**
+     * @brief 通知模型指定区间内的行被修改
+     * @param first 起始行
+     * @param last 结束行(包含)
+     */
+    void rowsChanged(int first, int last);
+    /**
+     * @brief 重新加载整个模型, 用于删除等无法定位区间的操作
+     */
+    void reload();
+
+private:
+    /**
+     * @brief 所属分页组件
+     */
+    PageTable* m_Table;
+    /**
+     * @brief 模型已公布的行数, 保证 begin/end 通知与 rowCount 一致
+     */
+    int m_RowCount;
+};
+
+#endif // PAGETABLEMODEL_H
@@ -0,0 +1,1108 @@
+#include "RowStore.h"
+
+#include <QSet>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QTemporaryFile>
+#include <QElapsedTimer>
+#include <QVarLengthArray>
+#include <cstring>
+
+// 记录格式: [槽位:4][记录字节数:4][单元格数:2],
+// 随后每个单元格为 编码列[编码:2]、字符串列[字符数:4][UTF-16 字符]、溢出列[文件偏移:8][字符数:4] 或 丢弃列(不占字节)
+static const int RecordHeader = 10;
+
+static inline quint16 read16(const char *p) {
+    quint16 v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+static inline quint32 read32(const char *p) {
+    quint32 v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+static inline void write16(char *p, quint16 v) {
+    memcpy(p, &v, sizeof(v));
+}
+static inline void write32(char *p, quint32 v) {
+    memcpy(p, &v, sizeof(v));
+}
+static inline quint64 read64(const char *p) {
+    quint64 v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+static inline void write64(char *p, quint64 v) {
+    memcpy(p, &v, sizeof(v));
+}
+
+/**
+* @brief 溢出列的临时文件, 取值为连续的 UTF-16 字符, 字符数保存在记录中; 导出快照可能在其他线程读取, 访问需加锁
+*
+* written 和 live 只由写入的存储在所在线程维护, 用于判断失效字节是否过多
+*/
+struct RowStore::Spill {
+    QTemporaryFile file;
+    QMutex mutex;
+    qint64 written = 0;
+    qint64 live = 0;
+};
+
+RowStore::RowStore(const QList<QStringList> &rows)
+    : m_Layout(0), m_ActiveBlock(-1), m_AutoEncoding(true), m_NextEvaluation(FirstEvaluation),
+      m_Compression(false), m_CompressionLevel(1), m_CacheBlocks(4), m_RenumberBlocks(0) {
+    append(rows);
+}
+
+/**
+* @brief 行数
+*/
+int RowStore::size() const {
+    return m_Order.size();
+}
+/**
+* @brief 列数, 即所有行中最大的单元格数量
+*/
+int RowStore::columnCount() const {
+    return m_Columns.size();
+}
+/**
+* @brief 获取单元格
+* @param row 行索引
+* @param column 列索引
+* @return 单元格文本, 越界时返回空字符串
+*/
+QString RowStore::cell(int row, int column) const {
+    if (row < 0 || row >= m_Order.size() || column < 0) {
+        return QString();
+    }
+    quint32 slot = m_Order.at(row);
+    const char *p = record(slot);
+    if (column >= read16(p + 8) || columnStorage(column) == Dropped) {
+        return QString();
+    }
+
+    // 跳过前面的单元格, 只解码目标单元格
+    const QVector<Column> &columns = layoutOf(int(m_Slots.at(slot).block));
+    p += RecordHeader;
+    for (int c = 0; c < column; c++) {
+        p += cellBytes(columns.at(c), p);
+    }
+    const Column &col = columns.at(column);
+    if (col.storage == Dropped) {
+        return QString();
+    }
+    if (col.storage == Spilled) {
+        return spillRead(col.spill.data(), read64(p), int(read32(p + 8)));
+    }
+    if (col.encoded) {
+        return col.dictionary.at(read16(p));
+    }
+    return QString(reinterpret_cast<const QChar *>(p + 4), int(read32(p)));
+}
+/**
+* @brief 获取整行数据
+* @param row 行索引
+* @param columns 只解码位为 1 的列, 其余列返回空字符串; 为空表示全部列
+* @return 行数据
+*/
+QStringList RowStore::row(int row, const QBitArray &columns) const {
+    if (row < 0 || row >= m_Order.size()) {
+        return QStringList();
+    }
+    return decodeSlot(m_Order.at(row), columns);
+}
+/**
+* @brief 获取行所在的槽位号; 槽位号在行被删除前保持不变, 修改不会改变槽位号
+* @param row 行索引
+*/
+quint32 RowStore::slotAt(int row) const {
+    return m_Order.at(row);
+}
+/**
+* @brief 按槽位号获取整行数据
+* @param slot 槽位号
+* @param columns 只解码位为 1 的列, 其余列返回空字符串; 为空表示全部列
+* @return 行数据; 槽位已删除时返回空
+*/
+QStringList RowStore::rowAtSlot(quint32 slot, const QBitArray &columns) const {
+    if (slot >= quint32(m_Slots.size()) || m_Slots.at(slot).block == DeadSlot) {
+        return QStringList();
+    }
+    return decodeSlot(slot, columns);
+}
+/**
+* @brief 获取指定区间的行数据
+* @param pos 起始行
+* @param length 行数
+* @return 行数据集合
+*/
+QList<QStringList> RowStore::mid(int pos, int length) const {
+    QList<QStringList> rows;
+    int end = qMin(pos + length, size());
+    for (int r = qMax(0, pos); r < end; r++) {
+        rows.append(row(r));
+    }
+    return rows;
+}
+/**
+* @brief 导出全部数据
+*/
+QList<QStringList> RowStore::toList() const {
+    return mid(0, size());
+}
+
+/**
+* @brief 在末尾追加一行
+*/
+void RowStore::append(const QStringList &row) {
+    quint32 slot = quint32(m_Slots.size());
+    m_Slots.append(Slot{DeadSlot, 0, 0});
+    m_Order.append(slot);
+    writeRecord(slot, row);
+
+    if (m_Order.size() >= m_NextEvaluation) {
+        evaluate();
+    }
+}
+/**
+* @brief 在末尾追加多行
+*/
+void RowStore::append(const QList<QStringList> &rows) {
+    for (const QStringList &row : rows) {
+        append(row);
+    }
+}
+/**
+* @brief 替换指定行, 旧记录成为墓碑
+* @param row 行索引, 必须在有效范围内
+* @param values 新的行数据
+*/
+void RowStore::set(int row, const QStringList &values) {
+    quint32 slot = m_Order.at(row);
+    release(slot);
+    writeRecord(slot, values);
+}
+/**
+* @brief 删除与给定行完全相同的所有行, 被删除的记录成为墓碑
+* @param rows 待删除的行集合
+* @return 实际删除的行数
+*
+* 直接在记录上比较, 编码列比较整数编码, 字符串列先比较长度再比较字节, 不解码单元格;
+* 溢出列先比较记录中的字符数, 相同时才读取文件, 每行至多读取一次; 丢弃的列不参与比较。
+* 按旧的列信息写入、尚未改写的记录解码后比较。
+*/
+int RowStore::removeAll(const QList<QStringList> &rows, QVector<RemovedRow> *removedRows) {
+    // 预先把待删除行的编码列转换为编码; 取值不在当前字典中的行不可能匹配按当前列信息写入的记录
+    struct Query {
+        QStringList values;
+        QStringList stored;
+        QVector<int> codes;
+        bool current;
+        int source;
+    };
+    QVector<Query> queries;
+    for (int i = 0; i < rows.size(); i++) {
+        const QStringList &values = rows.at(i);
+        if (values.size() > m_Columns.size()) {
+            continue;
+        }
+        Query query;
+        query.values = values;
+        query.stored = stored(values);
+        query.current = true;
+        query.source = i;
+        query.codes.fill(-1, values.size());
+        for (int c = 0; query.current && c < values.size(); c++) {
+            const Column &column = m_Columns.at(c);
+            if (column.encoded) {
+                auto it = column.lookup.constFind(values.at(c));
+                if (it == column.lookup.constEnd()) {
+                    query.current = false;
+                } else {
+                    query.codes[c] = it.value();
+                }
+            }
+        }
+        if (query.current || !m_Layouts.isEmpty()) {
+            queries.append(query);
+        }
+    }
+    if (queries.isEmpty()) {
+        return 0;
+    }
+    QBitArray spilledMask(m_Columns.size());
+    for (int c = 0; c < m_Columns.size(); c++) {
+        spilledMask.setBit(c, m_Columns.at(c).storage == Spilled);
+    }
+
+    int removedCount = 0;
+    int write = 0;
+    for (int r = 0; r < m_Order.size(); r++) {
+        quint32 slot = m_Order.at(r);
+        const char *rec = record(slot);
+        int width = read16(rec + 8);
+        bool current = m_Blocks.at(int(m_Slots.at(slot).block)).layout == m_Layout;
+        QStringList decoded;
+        bool spilledRead = false;
+
+        int matched = -1;
+        for (const Query &query : qAsConst(queries)) {
+            if (width != query.values.size()) {
+                continue;
+            }
+            if (!current) {
+                // 旧块的编码与当前字典无关, 解码一次后按字符串比较
+                if (decoded.isEmpty()) {
+                    decoded = decodeSlot(slot);
+                }
+                if (decoded == query.stored) {
+                    matched = query.source;
+                    break;
+                }
+                continue;
+            }
+            if (!query.current) {
+                continue;
+            }
+            bool match = true;
+            const char *p = rec + RecordHeader;
+            for (int c = 0; match && c < width; c++) {
+                const Column &column = m_Columns.at(c);
+                if (column.storage == Dropped) {
+                    continue;
+                } else if (column.storage == Spilled) {
+                    // 溢出列的取值在本行第一次需要时一并读出, 之后的查询直接比较
+                    int length = int(read32(p + 8));
+                    match = length == query.values.at(c).size();
+                    if (match && length > 0) {
+                        if (!spilledRead) {
+                            decoded = decodeRecord(rec, m_Columns, spilledMask);
+                            spilledRead = true;
+                        }
+                        match = decoded.at(c) == query.values.at(c);
+                    }
+                    p += 12;
+                } else if (column.encoded) {
+                    match = read16(p) == query.codes.at(c);
+                    p += 2;
+                } else {
+                    const QString &value = query.values.at(c);
+                    int length = int(read32(p));
+                    match = length == value.size() && memcmp(p + 4, value.constData(), size_t(length) * 2) == 0;
+                    p += 4 + length * 2;
+                }
+            }
+            if (match) {
+                matched = query.source;
+                break;
+            }
+        }
+
+        if (matched >= 0) {
+            release(slot);
+            removedCount++;
+            if (removedRows) {
+                RemovedRow removed;
+                removed.row = r;
+                removed.slot = slot;
+                removed.match = matched;
+                removedRows->append(removed);
+            }
+        } else {
+            m_Order[write++] = slot;
+        }
+    }
+    m_Order.resize(write);
+    return removedCount;
+}
+
+/**
+* @brief 是否有需要整理或改写记录头的数据块, 或需要换用新文件的溢出列
+*/
+bool RowStore::needsCompaction() const {
+    if (m_RenumberBlocks > 0) {
+        return true;
+    }
+    for (const Column &column : m_Columns) {
+        if (spillWasted(column)) {
+            return true;
+        }
+    }
+    for (int b = 0; b < m_Blocks.size(); b++) {
+        const Block &block = m_Blocks.at(b);
+        if (b != m_ActiveBlock && block.used > 0 && (block.live * 2 < block.used || block.layout != m_Layout)) {
+            return true;
+        }
+    }
+    return false;
+}
+/**
+* @brief 分片整理失效字节超过一半的数据块
+* @param budgetMs 本次整理的时间预算(毫秒)
+* @return 是否还有待整理的数据块
+*
+* 按顺序遍历块内的记录, 槽位仍指向该位置的记录是存活的, 复制到当前块并更新槽位;
+* 按旧的列信息写入的块逐条解码后按当前列信息重新写入, 仍使用同一溢出文件的列沿用原偏移。
+* 遍历完成后整块释放。槽位号不变, 行索引无需调整。
+*
+* 溢出文件的失效字节过多时, 该列先换用新文件(即新的列信息), 全部数据块随之过期,
+* 存活取值在改写时搬到新文件。回收槽位后尚未改写记录头的块先改写, 之后才能按记录头判断存活。
+*/
+bool RowStore::compactStep(int budgetMs) {
+    QElapsedTimer clock;
+    clock.start();
+
+    QVector<Column> fresh = m_Columns;
+    bool rotate = false;
+    for (Column &column : fresh) {
+        if (spillWasted(column)) {
+            column.spill.reset();
+            rotate = true;
+        }
+    }
+    if (rotate) {
+        beginLayout(fresh);
+    }
+
+    for (int b = 0; b < m_Blocks.size(); b++) {
+        if (m_Blocks.at(b).renumber) {
+            renumberBlock(b);
+            if (clock.elapsed() >= budgetMs) {
+                break;
+            }
+        }
+        const Block &candidate = m_Blocks.at(b);
+        bool stale = candidate.layout != m_Layout;
+        if (b == m_ActiveBlock || candidate.used == 0 || (!stale && candidate.live * 2 >= candidate.used)) {
+            continue;
+        }
+        // 已压缩的块先解压; 复制一份块和列信息, 之后分配新块、淘汰缓存或再次改变列信息都不影响读取
+        inflate(b);
+        const Block sparse = m_Blocks.at(b);
+        const QVector<Column> columns = layoutOf(b);
+
+        int offset = 0;
+        while (offset < sparse.used) {
+            const char *p = sparse.bytes.constData() + offset;
+            quint32 slot = read32(p);
+            int length = int(read32(p + 4));
+            if (slot < quint32(m_Slots.size()) && m_Slots.at(slot).block == quint32(b)
+                && m_Slots.at(slot).offset == quint32(offset)) {
+                if (stale) {
+                    // 溢出文件未变的列沿用原偏移, 不读取也不重复写入
+                    QVector<SpillCell> carried = spillCells(p, columns);
+                    QBitArray mask(columns.size(), true);
+                    for (int c = 0; c < carried.size(); c++) {
+                        if (carried.at(c).length < 0) {
+                            continue;
+                        }
+                        if (c < m_Columns.size() && m_Columns.at(c).storage == Spilled
+                            && m_Columns.at(c).spill == columns.at(c).spill) {
+                            mask.clearBit(c);
+                        } else {
+                            carried[c].length = -1;
+                        }
+                    }
+                    writeRecord(slot, decodeRecord(p, columns, mask), carried);
+                } else {
+                    int target = 0;
+                    int block = allocate(length, target);
+                    memcpy(m_Blocks[block].bytes.data() + target, p, size_t(length));
+                    m_Slots[slot].block = quint32(block);
+                    m_Slots[slot].offset = quint32(target);
+                }
+            }
+            offset += length;
+        }
+        freeBlock(b);
+
+        if (clock.elapsed() >= budgetMs) {
+            break;
+        }
+    }
+
+    // 大量删除后收缩行索引的容量
+    if (m_Order.capacity() > m_Order.size() * 2 + 4096) {
+        m_Order.squeeze();
+    }
+    return needsCompaction();
+}
+/**
+* @brief 墓碑槽位是否多到需要回收; 上一次回收的记录头尚未全部改写时不再回收
+*/
+bool RowStore::needsSlotReclaim() const {
+    if (m_RenumberBlocks > 0) {
+        return false;
+    }
+    int tombstones = m_Slots.size() - m_Order.size();
+    return tombstones > ReclaimSlots && tombstones > m_Order.size();
+}
+/**
+* @brief 回收墓碑槽位: 存活行按行序重新编号为 0 到 size()-1
+* @return 旧槽位号 -> 新槽位号的映射, 已删除的槽位映射为 DeadSlot
+*
+* 只重排槽位表和行索引。当前块之后还要继续写入, 记录头立即改写; 其余数据块只做标记,
+* 由 compactStep 按时间预算逐块改写, 失效记录改写为 DeadSlot, 整理时据此跳过。
+*/
+QVector<quint32> RowStore::reclaimSlots() {
+    QVector<quint32> remap(m_Slots.size(), DeadSlot);
+    QVector<Slot> renumbered(m_Order.size());
+    for (int r = 0; r < m_Order.size(); r++) {
+        remap[m_Order.at(r)] = quint32(r);
+        renumbered[r] = m_Slots.at(m_Order.at(r));
+    }
+
+    m_Slots = renumbered;
+    for (int r = 0; r < m_Order.size(); r++) {
+        m_Order[r] = quint32(r);
+    }
+
+    m_Renumber = remap;
+    for (int b = 0; b < m_Blocks.size(); b++) {
+        if (m_Blocks.at(b).used > 0) {
+            m_Blocks[b].renumber = true;
+            m_RenumberBlocks++;
+        }
+    }
+    if (m_ActiveBlock >= 0) {
+        renumberBlock(m_ActiveBlock);
+    }
+    return remap;
+}
+/**
+* @brief 获取内存占用统计
+*/
+RowStore::MemoryStats RowStore::memoryStats() const {
+    MemoryStats stats;
+    stats.rows = m_Order.size();
+    stats.tombstones = m_Slots.size() - m_Order.size();
+    for (const Block &block : qAsConst(m_Blocks)) {
+        if (block.bytes.isEmpty() && block.packed.isEmpty()) {
+            continue;
+        }
+        stats.blocks++;
+        stats.blockBytes += block.bytes.size() + block.packed.size();
+        stats.liveBytes += block.live;
+        stats.deadBytes += block.used - block.live;
+        if (!block.packed.isEmpty()) {
+            stats.compressedBlocks++;
+            stats.cachedBlocks += block.bytes.isEmpty() ? 0 : 1;
+            stats.compressedBytes += block.packed.size();
+            stats.savedBytes += block.used - block.packed.size() - block.bytes.size();
+        }
+    }
+    stats.indexBytes = qint64(m_Slots.capacity()) * qint64(sizeof(Slot))
+                     + qint64(m_Order.capacity()) * qint64(sizeof(quint32))
+                     + qint64(m_Renumber.capacity()) * qint64(sizeof(quint32))
+                     + qint64(m_Blocks.capacity()) * qint64(sizeof(Block));
+    // 同一文件可能被多个版本的列信息引用, 只计一次
+    QSet<Spill *> files;
+    for (const Column &column : m_Columns) {
+        files.insert(column.spill.data());
+    }
+    for (const QVector<Column> &layout : m_Layouts) {
+        for (const Column &column : layout) {
+            files.insert(column.spill.data());
+        }
+    }
+    for (Spill *spill : qAsConst(files)) {
+        if (spill) {
+            QMutexLocker locker(&spill->mutex);
+            stats.spilledBytes += spill->file.size();
+        }
+    }
+    for (const Column &column : m_Columns) {
+        for (const QString &value : column.dictionary) {
+            // 字符串头 + 字符 + 哈希节点, 估算值
+            stats.dictionaryBytes += 64 + value.size() * 2;
+        }
+    }
+    return stats;
+}
+
+/**
+* @brief 设置列的存储方式, 之后的记录按新方式写入, 已有记录由 compactStep 分片改写
+* @param column 列索引
+* @param storage 存储方式; 丢弃后取值不可恢复, 改回常驻内存时已有行的该列为空
+*/
+void RowStore::setColumnStorage(int column, ColumnStorage storage) {
+    if (column < 0 || column >= 0xFFFF) {
+        return;
+    }
+    while (m_Columns.size() <= column) {
+        m_Columns.append(Column());
+    }
+    if (m_Columns.at(column).storage == storage) {
+        return;
+    }
+
+    // 已有记录仍按原来的列信息读取, 由整理分片改写; 非常驻的列不编码
+    QVector<Column> columns = m_Columns;
+    Column &target = columns[column];
+    target.storage = storage;
+    target.encoded = false;
+    target.dictionary.clear();
+    target.lookup.clear();
+    target.spill.reset();
+    beginLayout(columns);
+}
+/**
+* @brief 获取列的存储方式
+*/
+RowStore::ColumnStorage RowStore::columnStorage(int column) const {
+    return column >= 0 && column < m_Columns.size() ? m_Columns.at(column).storage : Inline;
+}
+/**
+* @brief 将行数据转换为写入后读取得到的形式, 即丢弃的列置空
+*/
+QStringList RowStore::stored(const QStringList &values) const {
+    QStringList result = values;
+    int width = qMin(values.size(), m_Columns.size());
+    for (int c = 0; c < width; c++) {
+        if (m_Columns.at(c).storage == Dropped) {
+            result[c].clear();
+        }
+    }
+    return result;
+}
+/**
+* @brief 设置冷块压缩
+* @param enabled 是否启用; 关闭时全部数据块解压还原
+* @param cacheBlocks 解压缓存最多保留的块数, 每块约 1MB; 越大翻页越快, 内存越多
+* @param level qCompress 压缩级别, 1 最快, 9 压缩率最高
+*/
+void RowStore::setCompression(bool enabled, int cacheBlocks, int level) {
+    m_Compression = enabled;
+    m_CacheBlocks = qMax(1, cacheBlocks);
+    m_CompressionLevel = qBound(1, level, 9);
+    if (!enabled) {
+        for (int b = 0; b < m_Blocks.size(); b++) {
+            Block &block = m_Blocks[b];
+            if (!block.packed.isEmpty()) {
+                block.bytes = blockBytes(block);
+                block.packed = QByteArray();
+            }
+        }
+        m_Resident.clear();
+        return;
+    }
+    // 缓存容量变小时立即淘汰多余的块
+    while (m_Resident.size() > m_CacheBlocks) {
+        m_Blocks[m_Resident.takeFirst()].bytes = QByteArray();
+    }
+}
+/**
+* @brief 分片压缩冷块: 自上一次调用以来未被访问的块被压缩, 被访问过的块清除访问标记;
+*        同时淘汰期间未被访问的解压缓存
+* @param budgetMs 本次压缩的时间预算(毫秒)
+* @return 是否因时间预算用尽而提前结束
+*/
+bool RowStore::compressStep(int budgetMs) {
+    if (!m_Compression) {
+        return false;
+    }
+    QElapsedTimer clock;
+    clock.start();
+
+    for (int b = 0; b < m_Blocks.size(); b++) {
+        Block &block = m_Blocks[b];
+        if (b == m_ActiveBlock || block.used == 0) {
+            continue;
+        }
+        // 最近访问过的块保留到下一次, 类似时钟置换的第二次机会
+        if (block.touched) {
+            block.touched = false;
+            continue;
+        }
+        if (!block.packed.isEmpty()) {
+            // 已压缩: 期间未被访问的解压缓存直接丢弃
+            if (!block.bytes.isEmpty()) {
+                block.bytes = QByteArray();
+                m_Resident.removeOne(b);
+            }
+            continue;
+        }
+        // 失效字节过半、列信息已过期或记录头待改写的块留给整理, 整理后存活记录会搬到新块
+        if (block.live * 2 < block.used || block.layout != m_Layout || block.renumber) {
+            continue;
+        }
+        block.packed = qCompress(reinterpret_cast<const uchar *>(block.bytes.constData()), block.used, m_CompressionLevel);
+        block.bytes = QByteArray();
+
+        if (clock.elapsed() >= budgetMs) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+* @brief 设置是否自动启用字典编码, 关闭时已编码的列全部还原
+*/
+void RowStore::setAutoEncoding(bool enabled) {
+    m_AutoEncoding = enabled;
+    if (enabled) {
+        evaluate();
+        return;
+    }
+    QVector<Column> columns = m_Columns;
+    bool changed = false;
+    for (Column &column : columns) {
+        if (column.encoded) {
+            column.encoded = false;
+            column.dictionary.clear();
+            column.lookup.clear();
+            changed = true;
+        }
+    }
+    if (changed) {
+        beginLayout(columns);
+    }
+}
+/**
+* @brief 指定列当前是否为字典编码
+*/
+bool RowStore::isEncoded(int column) const {
+    return column >= 0 && column < m_Columns.size() && m_Columns.at(column).encoded;
+}
+
+/**
+* @brief 获取槽位对应记录的起始地址
+*/
+const char* RowStore::record(quint32 slot) const {
+    const Slot &location = m_Slots.at(slot);
+    int block = int(location.block);
+    if (!m_Blocks.at(block).touched) {
+        m_Blocks[block].touched = true;
+    }
+    if (!m_Blocks.at(block).packed.isEmpty()) {
+        inflate(block);
+    }
+    return m_Blocks.at(block).bytes.constData() + location.offset;
+}
+/**
+* @brief 获取数据块写入时的列信息
+*/
+const QVector<RowStore::Column> &RowStore::layoutOf(int block) const {
+    int layout = m_Blocks.at(block).layout;
+    return layout == m_Layout ? m_Columns : *m_Layouts.constFind(layout);
+}
+/**
+* @brief 解码槽位对应的记录; 旧块中写入后改为丢弃的列同样读取为空
+* @param mask 只解码位为 1 的列, 为空表示全部列
+*/
+QStringList RowStore::decodeSlot(quint32 slot, const QBitArray &mask) const {
+    const char *p = record(slot);
+    int block = int(m_Slots.at(slot).block);
+    if (m_Blocks.at(block).layout == m_Layout) {
+        return decodeRecord(p, m_Columns, mask);
+    }
+    return stored(decodeRecord(p, layoutOf(block), mask));
+}
+/**
+* @brief 确保已压缩的块在解压缓存中, 缓存满时淘汰最久未用的块
+*/
+void RowStore::inflate(int block) const {
+    if (!m_Blocks.at(block).bytes.isEmpty()) {
+        // 已在缓存中, 移到最近使用的位置; 连续读取同一块时无需移动
+        if (!m_Resident.isEmpty() && m_Resident.last() != block && m_Resident.removeOne(block)) {
+            m_Resident.append(block);
+        }
+        return;
+    }
+    m_Blocks[block].bytes = qUncompress(m_Blocks.at(block).packed);
+    m_Resident.append(block);
+    while (m_Resident.size() > m_CacheBlocks) {
+        m_Blocks[m_Resident.takeFirst()].bytes = QByteArray();
+    }
+}
+/**
+* @brief 获取块的原始字节, 已压缩且不在缓存中时临时解压, 不改变缓存
+*/
+QByteArray RowStore::blockBytes(const Block &block) {
+    return block.bytes.isEmpty() && !block.packed.isEmpty() ? qUncompress(block.packed) : block.bytes;
+}
+/**
+* @brief 按给定的列信息解码一条记录
+* @param mask 只解码位为 1 的列, 为空表示全部列
+*/
+QStringList RowStore::decodeRecord(const char *record, const QVector<Column> &columns, const QBitArray &mask) {
+    int width = read16(record + 8);
+    QStringList values;
+    values.reserve(width);
+    const char *p = record + RecordHeader;
+    for (int c = 0; c < width; c++) {
+        const Column &column = columns.at(c);
+        int bytes = cellBytes(column, p);
+        // 投影之外的列只跳过字节, 不构造字符串
+        if (!mask.isEmpty() && (c >= mask.size() || !mask.testBit(c))) {
+            values << QString();
+        } else if (column.storage == Dropped) {
+            values << QString();
+        } else if (column.storage == Spilled) {
+            values << spillRead(column.spill.data(), read64(p), int(read32(p + 8)));
+        } else if (column.encoded) {
+            values << column.dictionary.at(read16(p));
+        } else {
+            values << QString(reinterpret_cast<const QChar *>(p + 4), int(read32(p)));
+        }
+        p += bytes;
+    }
+    return values;
+}
+/**
+* @brief 单元格在记录中占用的字节数
+*/
+int RowStore::cellBytes(const Column &column, const char *p) {
+    switch (column.storage) {
+    case Dropped: return 0;
+    case Spilled: return 12;
+    default: return column.encoded ? 2 : 4 + int(read32(p)) * 2;
+    }
+}
+/**
+* @brief 取出记录中各溢出单元格的偏移和字符数, 不访问文件
+*/
+QVector<RowStore::SpillCell> RowStore::spillCells(const char *record, const QVector<Column> &columns) {
+    int width = read16(record + 8);
+    QVector<SpillCell> cells(width);
+    const char *p = record + RecordHeader;
+    for (int c = 0; c < width; c++) {
+        const Column &column = columns.at(c);
+        if (column.storage == Spilled) {
+            cells[c].offset = read64(p);
+            cells[c].length = int(read32(p + 8));
+        }
+        p += cellBytes(column, p);
+    }
+    return cells;
+}
+/**
+* @brief 溢出文件的失效字节是否多到需要换用新文件
+*/
+bool RowStore::spillWasted(const Column &column) {
+    if (column.storage != Spilled || !column.spill) {
+        return false;
+    }
+    qint64 dead = column.spill->written - column.spill->live;
+    return dead > SpillCompaction && dead > column.spill->live;
+}
+/**
+* @brief 追加写入列的溢出文件, 空字符串不写入
+* @return 取值在文件中的偏移
+*/
+quint64 RowStore::spillWrite(Column &column, const QString &value) {
+    if (value.isEmpty()) {
+        return 0;
+    }
+    if (!column.spill) {
+        column.spill.reset(new Spill());
+        column.spill->file.open();
+    }
+    Spill &spill = *column.spill;
+    qint64 bytes = qint64(value.size()) * 2;
+    QMutexLocker locker(&spill.mutex);
+    quint64 offset = quint64(spill.written);
+    spill.file.seek(spill.written);
+    spill.file.write(reinterpret_cast<const char *>(value.constData()), bytes);
+    spill.written += bytes;
+    spill.live += bytes;
+    return offset;
+}
+/**
+* @brief 从溢出文件读取取值
+*/
+QString RowStore::spillRead(Spill *spill, quint64 offset, int length) {
+    if (!spill || length <= 0) {
+        return QString();
+    }
+    QMutexLocker locker(&spill->mutex);
+    QString value(length, Qt::Uninitialized);
+    if (!spill->file.seek(qint64(offset))
+        || spill->file.read(reinterpret_cast<char *>(value.data()), qint64(length) * 2) != qint64(length) * 2) {
+        return QString();
+    }
+    return value;
+}
+/**
+* @brief 编码并写入一行记录到当前块, 更新槽位位置
+* @param carried 沿用的溢出单元格, 按列下标; 为空或 length 小于 0 的列写入新取值
+*/
+void RowStore::writeRecord(quint32 slot, const QStringList &values, const QVector<SpillCell> &carried) {
+    int width = qMin(values.size(), 0xFFFF);
+    while (m_Columns.size() < width) {
+        m_Columns.append(Column());
+    }
+
+    // 先取得编码列的编码; 字典已满的列改为字符串存储后重试
+    QVarLengthArray<int, 16> codes(width);
+    for (int c = 0; c < width; c++) {
+        codes[c] = -1;
+        if (m_Columns.at(c).encoded) {
+            codes[c] = intern(m_Columns[c], values.at(c));
+            if (codes[c] < 0) {
+                QVector<Column> columns = m_Columns;
+                columns[c].encoded = false;
+                columns[c].dictionary.clear();
+                columns[c].lookup.clear();
+                beginLayout(columns);
+                c = -1;
+            }
+        }
+    }
+
+    int bytes = RecordHeader;
+    for (int c = 0; c < width; c++) {
+        switch (m_Columns.at(c).storage) {
+        case Dropped: break;
+        case Spilled: bytes += 12; break;
+        default: bytes += codes[c] >= 0 ? 2 : 4 + values.at(c).size() * 2; break;
+        }
+    }
+
+    int offset = 0;
+    int block = allocate(bytes, offset);
+    char *p = m_Blocks[block].bytes.data() + offset;
+    write32(p, slot);
+    write32(p + 4, quint32(bytes));
+    write16(p + 8, quint16(width));
+    p += RecordHeader;
+    for (int c = 0; c < width; c++) {
+        if (m_Columns.at(c).storage == Dropped) {
+            continue;
+        } else if (m_Columns.at(c).storage == Spilled) {
+            if (c < carried.size() && carried.at(c).length >= 0) {
+                write64(p, carried.at(c).offset);
+                write32(p + 8, quint32(carried.at(c).length));
+            } else {
+                write64(p, spillWrite(m_Columns[c], values.at(c)));
+                write32(p + 8, quint32(values.at(c).size()));
+            }
+            p += 12;
+        } else if (codes[c] >= 0) {
+            write16(p, quint16(codes[c]));
+            p += 2;
+        } else {
+            const QString &value = values.at(c);
+            write32(p, quint32(value.size()));
+            memcpy(p + 4, value.constData(), size_t(value.size()) * 2);
+            p += 4 + value.size() * 2;
+        }
+    }
+
+    m_Slots[slot] = Slot{quint32(block), quint32(offset), quint32(bytes)};
+}
+/**
+* @brief 在当前块中分配空间, 不足时开启新块
+* @return 分配到的块下标, 偏移通过 offset 返回
+*/
+int RowStore::allocate(int bytes, int &offset) {
+    if (m_ActiveBlock < 0 || m_Blocks.at(m_ActiveBlock).bytes.size() - m_Blocks.at(m_ActiveBlock).used < bytes) {
+        // 当前块已写满; 其中的记录若已全部失效则直接释放
+        if (m_ActiveBlock >= 0 && m_Blocks.at(m_ActiveBlock).live == 0) {
+            freeBlock(m_ActiveBlock);
+        }
+        int index = m_Blocks.size();
+        if (!m_FreeBlocks.isEmpty()) {
+            index = m_FreeBlocks.takeLast();
+        } else {
+            m_Blocks.append(Block());
+        }
+        // 超长的行独占一个块
+        m_Blocks[index].bytes = QByteArray(qMax(int(BlockSize), bytes), Qt::Uninitialized);
+        m_Blocks[index].packed = QByteArray();
+        m_Blocks[index].used = 0;
+        m_Blocks[index].live = 0;
+        m_Blocks[index].touched = true;
+        m_Blocks[index].layout = m_Layout;
+        m_ActiveBlock = index;
+    }
+
+    Block &block = m_Blocks[m_ActiveBlock];
+    offset = block.used;
+    block.used += bytes;
+    block.live += bytes;
+    return m_ActiveBlock;
+}
+/**
+* @brief 将槽位的记录标记为失效
+*/
+void RowStore::release(quint32 slot) {
+    Slot &location = m_Slots[slot];
+    if (location.block == DeadSlot) {
+        return;
+    }
+    // 当前文件中的溢出取值随之失效; 须在释放块之前读取记录
+    const QVector<Column> &columns = layoutOf(int(location.block));
+    for (const Column &column : columns) {
+        if (column.storage == Spilled && column.spill) {
+            const QVector<SpillCell> cells = spillCells(record(slot), columns);
+            for (int c = 0; c < cells.size(); c++) {
+                if (cells.at(c).length > 0 && columns.at(c).spill) {
+                    columns.at(c).spill->live -= qint64(cells.at(c).length) * 2;
+                }
+            }
+            break;
+        }
+    }
+    Block &block = m_Blocks[location.block];
+    block.live -= int(location.length);
+    // 非当前块的记录全部失效时立即释放, 无需等待整理
+    if (block.live == 0 && int(location.block) != m_ActiveBlock) {
+        freeBlock(int(location.block));
+    }
+    location.block = DeadSlot;
+}
+/**
+* @brief 释放数据块内存
+*/
+void RowStore::freeBlock(int block) {
+    int layout = m_Blocks.at(block).layout;
+    settleRenumber(block);
+    m_Blocks[block] = Block();
+    m_Resident.removeOne(block);
+    m_FreeBlocks.append(block);
+    if (block == m_ActiveBlock) {
+        m_ActiveBlock = -1;
+    }
+    pruneLayout(layout);
+}
+/**
+* @brief 按上一次回收槽位的映射改写数据块中记录头的槽位号, 已失效的记录改写为 DeadSlot
+*
+* 已压缩且不在解压缓存中的块解压到临时缓冲, 改写后重新压缩, 不占用解压缓存。
+*/
+void RowStore::renumberBlock(int block) {
+    Block &target = m_Blocks[block];
+    QByteArray scratch;
+    if (target.bytes.isEmpty()) {
+        scratch = qUncompress(target.packed);
+    }
+    QByteArray &bytes = target.bytes.isEmpty() ? scratch : target.bytes;
+
+    char *data = bytes.data();
+    int offset = 0;
+    while (offset < target.used) {
+        char *p = data + offset;
+        quint32 slot = read32(p);
+        quint32 renumbered = slot < quint32(m_Renumber.size()) ? m_Renumber.at(int(slot)) : DeadSlot;
+        // 回收之后被修改或删除的记录不再是槽位的当前位置, 同样视为失效
+        bool live = renumbered < quint32(m_Slots.size()) && m_Slots.at(int(renumbered)).block == quint32(block)
+                    && m_Slots.at(int(renumbered)).offset == quint32(offset);
+        write32(p, live ? renumbered : DeadSlot);
+        offset += int(read32(p + 4));
+    }
+    if (!target.packed.isEmpty()) {
+        target.packed = qCompress(reinterpret_cast<const uchar *>(bytes.constData()), target.used, m_CompressionLevel);
+    }
+    settleRenumber(block);
+}
+/**
+* @brief 数据块的记录头已改写或块已释放, 全部完成后释放映射
+*/
+void RowStore::settleRenumber(int block) {
+    if (!m_Blocks.at(block).renumber) {
+        return;
+    }
+    m_Blocks[block].renumber = false;
+    if (--m_RenumberBlocks == 0) {
+        m_Renumber = QVector<quint32>();
+    }
+}
+/**
+* @brief 查询或登记字典编码
+* @return 编码; 字典已满时返回 -1
+*/
+int RowStore::intern(Column &column, const QString &value) {
+    auto it = column.lookup.constFind(value);
+    if (it != column.lookup.constEnd()) {
+        return it.value();
+    }
+    if (column.dictionary.size() >= MaxDictionarySize) {
+        return -1;
+    }
+    quint16 code = quint16(column.dictionary.size());
+    column.dictionary.append(value);
+    column.lookup.insert(value, code);
+    return code;
+}
+/**
+* @brief 以新的列信息写入之后的记录, 已有记录由 compactStep 分片改写
+*
+* 当前块按原来的列信息保留, 之后的记录写入新块; 新编码的列从空字典开始, 改写时逐条登记。
+*/
+void RowStore::beginLayout(const QVector<Column> &columns) {
+    int previous = m_Layout;
+    m_Layouts.insert(previous, m_Columns);
+    m_Columns = columns;
+    m_Layout++;
+    if (m_ActiveBlock >= 0 && m_Blocks.at(m_ActiveBlock).live == 0) {
+        freeBlock(m_ActiveBlock);
+    }
+    m_ActiveBlock = -1;
+    pruneLayout(previous);
+}
+/**
+* @brief 旧版本的列信息不再被任何数据块使用时释放
+*/
+void RowStore::pruneLayout(int layout) {
+    if (layout == m_Layout || !m_Layouts.contains(layout)) {
+        return;
+    }
+    for (const Block &block : qAsConst(m_Blocks)) {
+        if (block.used > 0 && block.layout == layout) {
+            return;
+        }
+    }
+    m_Layouts.remove(layout);
+}
+/**
+* @brief 根据抽样统计重新决定各列的编码方式
+*
+* 抽样最近写入的行, 不同取值不超过样本的 1/16 时视为低基数列并编码;
+* 已编码的列若字典超过总行数的一半, 说明基数已经变高, 还原为字符串存储。
+* 只决定新的列信息, 已有记录由 compactStep 在空闲时分片改写。
+*/
+void RowStore::evaluate() {
+    int count = m_Order.size();
+    while (m_NextEvaluation <= count) {
+        m_NextEvaluation *= 2;
+    }
+    if (!m_AutoEncoding || count == 0) {
+        return;
+    }
+
+    int sampled = qMin(count, int(SampleRows));
+    QList<QStringList> sample = mid(count - sampled, sampled);
+    int maxDistinct = sampled / 16;
+
+    QVector<Column> columns = m_Columns;
+    bool changed = false;
+    for (int c = 0; c < columns.size(); c++) {
+        Column &column = columns[c];
+        bool encode = column.encoded;
+        if (column.storage != Inline) {
+            encode = false;
+        } else if (column.encoded) {
+            encode = column.dictionary.size() * 2 <= count;
+        } else {
+            QSet<QString> distinct;
+            for (int r = 0; r < sample.size() && distinct.size() <= maxDistinct; r++) {
+                distinct.insert(sample.at(r).value(c));
+            }
+            encode = distinct.size() <= maxDistinct;
+        }
+        if (encode != column.encoded) {
+            // 新编码的列从空字典开始, 改写记录时逐条登记
+            column.encoded = encode;
+            column.dictionary.clear();
+            column.lookup.clear();
+            changed = true;
+        }
+    }
+    if (changed) {
+        beginLayout(columns);
+    }
+}
@@ -0,0 +1,454 @@
+#ifndef ROWSTORE_H
+#define ROWSTORE_H
+
+#include <QHash>
+#include <QVector>
+#include <QBitArray>
+#include <QByteArray>
+#include <QSharedPointer>
+#include <QStringList>
+
+/**
+ * @author : LMH
+ * @date   : 2026.10.18
+ * @brief  : 分页组件的行数据存储
+ *
+ * 每行编码为一条连续记录, 写入 1MB 的大块内存(arena), 行索引只保存记录所在的槽位,
+ * 追加一行只是在当前块末尾写入, 不再为每个单元格单独分配字符串。
+ * 修改和删除只把旧记录标记为失效(墓碑), 失效字节较多的块由 compactStep 分片整理:
+ * 存活记录搬到新块, 旧块整体释放。墓碑槽位过多时由 reclaimSlots 按行序重新编号。
+ *
+ * 低基数的列(状态、代码、单位等)自动采用字典编码: 每列维护一张字符串字典,
+ * 单元格只保存 16 位编码; 是否编码由列的统计信息决定, 数据增长时周期性重新评估。
+ * 取单元格时才解码, 字典列的相同取值共享同一个字符串。
+ *
+ * 每个数据块记录写入时的列信息(编码方式和存储方式)。列信息改变后新记录按新方式写入,
+ * 旧块仍按原来的列信息读取, 由 compactStep 分片改写, 不会一次性重写全部记录。
+ *
+ * 可选的冷块压缩: 一段时间内未被访问的数据块以 qCompress 压缩, 原始字节随即释放;
+ * 读取时按需解压到容量有限的 LRU 缓存, 缓存满时淘汰最久未用的块, 压缩数据始终保留, 淘汰无需重新压缩。
+ *
+ * 不需要常驻内存的列可以丢弃或溢出到临时文件: 丢弃的列不再保存取值, 读取为空;
+ * 溢出的列只在记录中保留文件偏移和字符数, 取值追加写入该列的临时文件, 读取该列时才访问文件。
+ * 改写记录时沿用已有的偏移, 不重复写入; 文件中的失效字节超过存活字节时换用新文件,
+ * 存活取值随 compactStep 分片改写搬到新文件, 旧文件在不再被引用时删除。
+ *
+ * 存储可按值复制, 所有成员隐式共享, 复制只增加引用计数; 副本即一致的快照,
+ * 可交给工作线程只读访问, 原存储之后的修改会自动分离, 不影响快照。
+ * 分离不是免费的: 快照存在期间的第一次修改会整体复制槽位表和行顺序(每行 16 字节)及块描述数组,
+ * 数据块的字节按块共享, 只有被写入的块才复制。
+ */
+class RowStore {
+
+public:
+    /**
+     * @brief 列的存储方式枚举: 常驻内存、丢弃、溢出到临时文件
+     */
+    enum ColumnStorage {
+        Inline = 0,
+        Dropped = 1,
+        Spilled = 2
+    };
+
+    /**
+     * @brief 内存占用统计, 单位为字节
+     */
+    struct MemoryStats {
+        int rows = 0;            // 存活行数
+        int tombstones = 0;      // 已删除但槽位仍保留的行数
+        int blocks = 0;          // 已分配的数据块数量
+        qint64 blockBytes = 0;   // 数据块占用的内存
+        qint64 liveBytes = 0;    // 存活记录的字节数
+        qint64 deadBytes = 0;    // 失效记录的字节数, 整理后释放
+        qint64 indexBytes = 0;   // 行索引和槽位表占用的内存
+        qint64 dictionaryBytes = 0; // 字典占用的内存(估算)
+        int compressedBlocks = 0;   // 已压缩的数据块数量
+        int cachedBlocks = 0;       // 已压缩且当前解压在缓存中的数据块数量
+        qint64 compressedBytes = 0; // 压缩数据占用的内存, 已计入 blockBytes
+        qint64 savedBytes = 0;      // 压缩相对原始记录字节节省的内存
+        qint64 spilledBytes = 0;    // 溢出列临时文件的总字节数(含失效取值), 不计入内存
+        qint64 total() const { return blockBytes + indexBytes + dictionaryBytes; }
+    };
+
+    /**
+     * @brief 被删除的行
+     */
+    struct RemovedRow {
+        int row = 0;        // 删除前的行索引
+        quint32 slot = 0;   // 槽位号
+        int match = 0;      // 匹配的待删除行在参数中的下标
+    };
+
+    explicit RowStore(const QList<QStringList> &rows = QList<QStringList>());
+
+    /**
+     * @brief 行数
+     */
+    int size() const;
+    /**
+     * @brief 列数, 即所有行中最大的单元格数量
+     */
+    int columnCount() const;
+    /**
+     * @brief 获取单元格
+     * @param row 行索引
+     * @param column 列索引
+     * @return 单元格文本, 越界时返回空字符串
+     */
+    QString cell(int row, int column) const;
+    /**
+     * @brief 获取整行数据
+     * @param row 行索引
+     * @param columns 只解码位为 1 的列, 其余列返回空字符串; 为空表示全部列
+     * @return 行数据
+     */
+    QStringList row(int row, const QBitArray &columns = QBitArray()) const;
+    /**
+     * @brief 获取行所在的槽位号; 槽位号在行被删除前保持不变, 修改不会改变槽位号
+     * @param row 行索引
+     */
+    quint32 slotAt(int row) const;
+    /**
+     * @brief 按槽位号获取整行数据
+     * @param slot 槽位号
+     * @param columns 只解码位为 1 的列, 其余列返回空字符串; 为空表示全部列
+     * @return 行数据; 槽位已删除时返回空
+     */
+    QStringList rowAtSlot(quint32 slot, const QBitArray &columns = QBitArray()) const;
+    /**
+     * @brief 获取指定区间的行数据
+     * @param pos 起始行
+     * @param length 行数
+     * @return 行数据集合
+     */
+    QList<QStringList> mid(int pos, int length) const;
+    /**
+     * @brief 导出全部数据
+     */
+    QList<QStringList> toList() const;
+
+    /**
+     * @brief 在末尾追加一行
+     */
+    void append(const QStringList &row);
+    /**
+     * @brief 在末尾追加多行
+     */
+    void append(const QList<QStringList> &rows);
+    /**
+     * @brief 替换指定行, 旧记录成为墓碑
+     * @param row 行索引, 必须在有效范围内
+     * @param values 新的行数据
+     */
+    void set(int row, const QStringList &values);
+    /**
+     * @brief 删除与给定行完全相同的所有行, 被删除的记录成为墓碑
+     * @param rows 待删除的行集合
+     * @param removedRows 可选, 按行索引升序输出被删除的行, 供外部索引同步和变更通知
+     * @return 实际删除的行数
+     *
+     * 直接在记录上比较, 编码列比较整数编码, 字符串列先比较长度再比较字节, 不解码单元格;
+     * 丢弃的列不参与比较。
+     */
+    int removeAll(const QList<QStringList> &rows, QVector<RemovedRow> *removedRows = nullptr);
+
+    /**
+     * @brief 是否有需要整理或按新的列信息改写的数据块, 或需要换用新文件的溢出列
+     */
+    bool needsCompaction() const;
+    /**
+     * @brief 分片整理失效字节超过一半的数据块, 并改写按旧的列信息写入或回收槽位后尚未改写记录头的数据块
+     * @param budgetMs 本次整理的时间预算(毫秒)
+     * @return 是否还有待整理的数据块
+     */
+    bool compactStep(int budgetMs);
+    /**
+     * @brief 墓碑槽位是否多到需要回收; 上一次回收的记录头尚未全部改写时不再回收
+     */
+    bool needsSlotReclaim() const;
+    /**
+     * @brief 回收墓碑槽位: 存活行按行序重新编号为 0 到 size()-1
+     * @return 旧槽位号 -> 新槽位号的映射, 已删除的槽位映射为 0xFFFFFFFF;
+     *         行索引按槽位号递增, 新旧槽位号的先后顺序一致
+     *
+     * 只重排槽位表和行索引, 耗时与行数成正比; 当前块的记录头立即改写, 其余数据块的记录头
+     * 由 compactStep 按时间预算逐块改写, 已压缩的块在临时缓冲中解压改写后重新压缩, 不占用解压缓存。
+     */
+    QVector<quint32> reclaimSlots();
+    /**
+     * @brief 获取内存占用统计
+     */
+    MemoryStats memoryStats() const;
+
+    /**
+     * @brief 设置冷块压缩
+     * @param enabled 是否启用; 关闭时全部数据块解压还原
+     * @param cacheBlocks 解压缓存最多保留的块数, 每块约 1MB; 越大翻页越快, 内存越多
+     * @param level qCompress 压缩级别, 1 最快, 9 压缩率最高
+     */
+    void setCompression(bool enabled, int cacheBlocks, int level);
+    /**
+     * @brief 分片压缩冷块: 自上一次调用以来未被访问的块被压缩, 被访问过的块清除访问标记;
+     *        同时淘汰期间未被访问的解压缓存
+     * @param budgetMs 本次压缩的时间预算(毫秒)
+     * @return 是否因时间预算用尽而提前结束
+     */
+    bool compressStep(int budgetMs);
+
+    /**
+     * @brief 设置是否自动启用字典编码, 关闭时已编码的列全部还原
+     */
+    void setAutoEncoding(bool enabled);
+    /**
+     * @brief 指定列当前是否为字典编码
+     */
+    bool isEncoded(int column) const;
+
+    /**
+     * @brief 设置列的存储方式, 之后的记录按新方式写入, 已有记录由 compactStep 分片改写
+     * @param column 列索引
+     * @param storage 存储方式; 丢弃后取值不可恢复, 改回常驻内存时已有行的该列为空
+     */
+    void setColumnStorage(int column, ColumnStorage storage);
+    /**
+     * @brief 获取列的存储方式
+     */
+    ColumnStorage columnStorage(int column) const;
+    /**
+     * @brief 将行数据转换为写入后读取得到的形式, 即丢弃的列置空
+     */
+    QStringList stored(const QStringList &values) const;
+
+private:
+    /**
+     * @brief 溢出列的临时文件, 定义见实现文件
+     */
+    struct Spill;
+    /**
+     * @brief 列信息: 存储方式、是否编码及其字典; 只有常驻内存的列可以编码
+     */
+    struct Column {
+        ColumnStorage storage = Inline;
+        bool encoded = false;
+        QStringList dictionary;
+        QHash<QString, quint16> lookup;
+        QSharedPointer<Spill> spill;    // 溢出列的临时文件, 首次写入时创建
+    };
+    /**
+     * @brief 记录中的溢出单元格; length 小于 0 表示不是溢出列
+     */
+    struct SpillCell {
+        quint64 offset = 0;
+        int length = -1;
+    };
+    /**
+     * @brief 数据块, used 之前的字节为已写入的记录; used 为 0 表示已释放
+     *        packed 非空表示已压缩, 此时 bytes 为空或为解压缓存; layout 为记录写入时的列信息版本;
+     *        renumber 表示记录头中的槽位号仍是回收之前的编号
+     */
+    struct Block {
+        QByteArray bytes;
+        QByteArray packed;
+        int used = 0;
+        int live = 0;
+        bool touched = true;
+        int layout = 0;
+        bool renumber = false;
+    };
+    /**
+     * @brief 槽位: 记录所在的块、偏移和长度; block 为 DeadSlot 表示已删除
+     */
+    struct Slot {
+        quint32 block;
+        quint32 offset;
+        quint32 length;
+    };
+
+    /**
+     * @brief 字典最大容量, 超出后该列还原为字符串存储
+     */
+    static constexpr int MaxDictionarySize = 65535;
+    /**
+     * @brief 统计时抽样的行数
+     */
+    static constexpr int SampleRows = 4096;
+    /**
+     * @brief 首次评估编码的行数阈值, 之后每翻倍评估一次
+     */
+    static constexpr int FirstEvaluation = 1024;
+    /**
+     * @brief 数据块大小
+     */
+    static constexpr int BlockSize = 1 << 20;
+    /**
+     * @brief 回收槽位的最少墓碑数量, 同时须超过存活行数
+     */
+    static constexpr int ReclaimSlots = 65536;
+    /**
+     * @brief 换用新溢出文件的最少失效字节数, 同时须超过存活字节数
+     */
+    static constexpr qint64 SpillCompaction = qint64(16) << 20;
+    /**
+     * @brief 已删除槽位的块标记
+     */
+    static constexpr quint32 DeadSlot = 0xFFFFFFFFu;
+
+    /**
+     * @brief 列集合, 即新记录写入时使用的列信息
+     */
+    QVector<Column> m_Columns;
+    /**
+     * @brief 当前列信息的版本
+     */
+    int m_Layout;
+    /**
+     * @brief 仍有数据块使用的旧版本列信息
+     */
+    QHash<int, QVector<Column>> m_Layouts;
+    /**
+     * @brief 数据块集合, 释放的块保留下标以便复用; 只读访问时也会更新访问标记和解压缓存
+     */
+    mutable QVector<Block> m_Blocks;
+    /**
+     * @brief 已释放可复用的块下标
+     */
+    QVector<int> m_FreeBlocks;
+    /**
+     * @brief 当前写入的块下标, -1 表示尚未分配
+     */
+    int m_ActiveBlock;
+    /**
+     * @brief 槽位表, 槽位号在行的生命周期内保持不变, 整理只更新其位置
+     */
+    QVector<Slot> m_Slots;
+    /**
+     * @brief 行索引 -> 槽位号
+     */
+    QVector<quint32> m_Order;
+    /**
+     * @brief 是否自动启用字典编码
+     */
+    bool m_AutoEncoding;
+    /**
+     * @brief 下一次评估编码时的行数
+     */
+    int m_NextEvaluation;
+    /**
+     * @brief 是否启用冷块压缩
+     */
+    bool m_Compression;
+    /**
+     * @brief 压缩级别
+     */
+    int m_CompressionLevel;
+    /**
+     * @brief 解压缓存最多保留的块数
+     */
+    int m_CacheBlocks;
+    /**
+     * @brief 解压缓存中的块下标, 末尾为最近使用
+     */
+    mutable QVector<int> m_Resident;
+    /**
+     * @brief 上一次回收槽位的映射, 旧槽位号 -> 新槽位号; 仍有数据块的记录头未改写时保留
+     */
+    QVector<quint32> m_Renumber;
+    /**
+     * @brief 记录头尚未改写的数据块数量
+     */
+    int m_RenumberBlocks;
+
+    /**
+     * @brief 获取槽位对应记录的起始地址
+     */
+    const char* record(quint32 slot) const;
+    /**
+     * @brief 确保已压缩的块在解压缓存中, 缓存满时淘汰最久未用的块
+     */
+    void inflate(int block) const;
+    /**
+     * @brief 获取数据块写入时的列信息
+     */
+    const QVector<Column> &layoutOf(int block) const;
+    /**
+     * @brief 解码槽位对应的记录; 旧块中写入后改为丢弃的列同样读取为空
+     * @param mask 只解码位为 1 的列, 为空表示全部列
+     */
+    QStringList decodeSlot(quint32 slot, const QBitArray &mask = QBitArray()) const;
+    /**
+     * @brief 获取块的原始字节, 已压缩且不在缓存中时临时解压, 不改变缓存
+     */
+    static QByteArray blockBytes(const Block &block);
+    /**
+     * @brief 按给定的列信息解码一条记录
+     * @param mask 只解码位为 1 的列, 为空表示全部列
+     */
+    static QStringList decodeRecord(const char *record, const QVector<Column> &columns,
+                                    const QBitArray &mask = QBitArray());
+    /**
+     * @brief 单元格在记录中占用的字节数
+     */
+    static int cellBytes(const Column &column, const char *p);
+    /**
+     * @brief 取出记录中各溢出单元格的偏移和字符数, 不访问文件
+     */
+    static QVector<SpillCell> spillCells(const char *record, const QVector<Column> &columns);
+    /**
+     * @brief 溢出文件的失效字节是否多到需要换用新文件
+     */
+    static bool spillWasted(const Column &column);
+    /**
+     * @brief 追加写入列的溢出文件, 空字符串不写入
+     * @return 取值在文件中的偏移
+     */
+    static quint64 spillWrite(Column &column, const QString &value);
+    /**
+     * @brief 从溢出文件读取取值
+     */
+    static QString spillRead(Spill *spill, quint64 offset, int length);
+    /**
+     * @brief 编码并写入一行记录到当前块, 更新槽位位置
+     * @param carried 沿用的溢出单元格, 按列下标; 为空或 length 小于 0 的列写入新取值
+     */
+    void writeRecord(quint32 slot, const QStringList &values, const QVector<SpillCell> &carried = QVector<SpillCell>());
+    /**
+     * @brief 在当前块中分配空间, 不足时开启新块
+     * @return 分配到的块下标, 偏移通过 offset 返回
+     */
+    int allocate(int bytes, int &offset);
+    /**
+     * @brief 将槽位的记录标记为失效
+     */
+    void release(quint32 slot);
+    /**
+     * @brief 释放数据块内存
+     */
+    void freeBlock(int block);
+    /**
+     * @brief 按上一次回收槽位的映射改写数据块中记录头的槽位号, 已失效的记录改写为 DeadSlot
+     */
+    void renumberBlock(int block);
+    /**
+     * @brief 数据块的记录头已改写或块已释放, 全部完成后释放映射
+     */
+    void settleRenumber(int block);
+    /**
+     * @brief 查询或登记字典编码
+     * @return 编码; 字典已满时返回 -1
+     */
+    int intern(Column &column, const QString &value);
+    /**
+     * @brief 以新的列信息写入之后的记录, 已有记录由 compactStep 分片改写
+     */
+    void beginLayout(const QVector<Column> &columns);
+    /**
+     * @brief 旧版本的列信息不再被任何数据块使用时释放
+     */
+    void pruneLayout(int layout);
+    /**
+     * @brief 根据抽样统计重新决定各列的编码方式
+     */
+    void evaluate();
+};
+
+#endif // ROWSTORE_H
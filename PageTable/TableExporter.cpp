@@ -0,0 +1,95 @@
+#include "TableExporter.h"
+
+#include <QSaveFile>
+#include "FeedProtocol.h"
+
+/**
+* @brief 导出数据
+* @param source 行来源, 每次取一块
+* @param total 总行数
+* @param header 表头, 仅 CSV 格式写入
+* @param path 文件路径, 写入完成后才替换目标文件
+* @param format 导出格式
+* @param progress 进度回调, 可为空
+* @param error 出错时的错误信息
+* @return 是否成功
+*/
+bool TableExporter::write(const Source &source, qint64 total, const QStringList &header,
+                          const QString &path, Format format, const Progress &progress, QString *error) {
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (error) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+
+    QByteArray chunk;
+    if (format == Csv) {
+        chunk.append("\xEF\xBB\xBF"); // UTF-8 BOM, 便于表格软件识别中文
+        appendCsvRow(chunk, header);
+    }
+
+    // 每次只解码一块行, 写出后即释放
+    for (qint64 start = 0; start < total; start += ChunkRows) {
+        qint64 end = qMin(total, start + ChunkRows);
+        const QList<QStringList> rows = source(start, int(end - start));
+
+        if (format == Csv) {
+            for (const QStringList &row : qAsConst(rows)) {
+                appendCsvRow(chunk, row);
+            }
+        } else {
+            FeedProtocol::encode(chunk, 0, rows);
+        }
+        if (file.write(chunk) != chunk.size()) {
+            if (error) {
+                *error = file.errorString();
+            }
+            file.cancelWriting();
+            return false;
+        }
+        chunk.clear();
+
+        if (progress) {
+            progress(end, total);
+        }
+    }
+
+    if (!chunk.isEmpty() && file.write(chunk) != chunk.size()) {
+        if (error) {
+            *error = file.errorString();
+        }
+        file.cancelWriting();
+        return false;
+    }
+    if (!file.commit()) {
+        if (error) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+    if (progress && total == 0) {
+        progress(0, 0);
+    }
+    return true;
+}
+
+/**
+* @brief 按 RFC 4180 转义 CSV 字段并追加到 out
+*/
+void TableExporter::appendCsvRow(QByteArray &out, const QStringList &row) {
+    for (int i = 0; i < row.size(); i++) {
+        if (i > 0) {
+            out.append(',');
+        }
+        QByteArray field = row.at(i).toUtf8();
+        if (field.contains(',') || field.contains('"') || field.contains('\n') || field.contains('\r')) {
+            field.replace("\"", "\"\"");
+            out.append('"').append(field).append('"');
+        } else {
+            out.append(field);
+        }
+    }
+    out.append("\r\n");
+}
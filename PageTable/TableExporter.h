@@ -0,0 +1,62 @@
+#ifndef TABLEEXPORTER_H
+#define TABLEEXPORTER_H
+
+#include <functional>
+#include <QVector>
+#include <QStringList>
+
+/**
+ * @author : LMH
+ * @date   : 2026.10.18
+ * @brief  : 表格导出工具, 从行来源中分块读取行并流式写入文件, 内存占用与行数无关
+ *
+ * 行来源通常只读访问存储快照, 可在工作线程执行。
+ */
+class TableExporter {
+
+public:
+    /**
+     * @brief 导出格式: CSV、二进制(与 FeedProtocol 数据帧相同, 可直接回放给接入服务)
+     */
+    enum Format {
+        Csv = 0,
+        Binary = 1
+    };
+
+    /**
+     * @brief 进度回调, 参数为已写入行数和总行数
+     */
+    typedef std::function<void(qint64 written, qint64 total)> Progress;
+
+    /**
+     * @brief 行来源, 按导出顺序返回从 first 开始的 count 行; 在工作线程调用
+     */
+    typedef std::function<QList<QStringList>(qint64 first, int count)> Source;
+
+    /**
+     * @brief 每块的行数, 每写完一块汇报一次进度
+     */
+    static constexpr int ChunkRows = 4096;
+
+    /**
+     * @brief 导出数据
+     * @param source 行来源, 每次取一块
+     * @param total 总行数
+     * @param header 表头, 仅 CSV 格式写入
+     * @param path 文件路径, 写入完成后才替换目标文件
+     * @param format 导出格式
+     * @param progress 进度回调, 可为空
+     * @param error 出错时的错误信息
+     * @return 是否成功
+     */
+    static bool write(const Source &source, qint64 total, const QStringList &header,
+                      const QString &path, Format format, const Progress &progress, QString *error = nullptr);
+
+private:
+    /**
+     * @brief 按 RFC 4180 转义 CSV 字段并追加到 out
+     */
+    static void appendCsvRow(QByteArray &out, const QStringList &row);
+};
+
+#endif // TABLEEXPORTER_H
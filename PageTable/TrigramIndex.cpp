@@ -0,0 +1,252 @@
+#include "TrigramIndex.h"
+
+#include <QElapsedTimer>
+#include <algorithm>
+
+TrigramIndex::TrigramIndex() : m_PostingCount(0) {
+}
+
+/**
+* @brief 设置参与索引和匹配的列, 为空表示全部列; 调用后应重新登记所有行
+*/
+void TrigramIndex::setColumns(const QList<int> &columns) {
+    m_Columns = columns;
+}
+/**
+* @brief 清空索引, 保留列设置
+*/
+void TrigramIndex::clear() {
+    m_Postings.clear();
+    m_PostingCount = 0;
+    m_Pending.clear();
+    m_Mapping = QVector<quint32>();
+}
+/**
+* @brief 登记一行
+* @param slot 行的槽位号
+* @param row 行数据
+*/
+void TrigramIndex::insert(quint32 slot, const QStringList &row) {
+    for (quint64 trigram : rowTrigrams(row)) {
+        QVector<quint32> &list = m_Postings[trigram];
+        settle(trigram, list);
+        // 追加的行槽位号递增, 直接写入末尾; 修改后重新登记的行按二分查找插入
+        if (list.isEmpty() || list.last() < slot) {
+            list.append(slot);
+        } else {
+            auto it = std::lower_bound(list.begin(), list.end(), slot);
+            if (*it == slot) {
+                continue;
+            }
+            list.insert(it, slot);
+        }
+        m_PostingCount++;
+    }
+}
+/**
+* @brief 移除一行, 行数据须与登记时一致
+* @param slot 行的槽位号
+* @param row 行数据
+*/
+void TrigramIndex::remove(quint32 slot, const QStringList &row) {
+    for (quint64 trigram : rowTrigrams(row)) {
+        auto entry = m_Postings.find(trigram);
+        if (entry == m_Postings.end()) {
+            continue;
+        }
+        QVector<quint32> &list = entry.value();
+        settle(trigram, list);
+        auto it = std::lower_bound(list.begin(), list.end(), slot);
+        if (it != list.end() && *it == slot) {
+            list.erase(it);
+            m_PostingCount--;
+        }
+        if (list.isEmpty()) {
+            m_Postings.erase(entry);
+        }
+    }
+}
+/**
+* @brief 按映射改写槽位号, 映射须保持槽位号的先后顺序, 倒排表仍保持升序
+* @param mapping 旧槽位号 -> 新槽位号
+*
+* 只登记映射, 倒排表由 remapStep 分片改写; 之后的登记、移除和查询照常使用新槽位号。
+*/
+void TrigramIndex::remap(const QVector<quint32> &mapping) {
+    // 两次映射不能叠加在同一张倒排表上, 上一次未完成的先全部改写
+    remapStep(0);
+    m_Mapping = mapping;
+    m_Pending.reserve(m_Postings.size());
+    for (auto it = m_Postings.constBegin(); it != m_Postings.constEnd(); ++it) {
+        m_Pending.insert(it.key());
+    }
+    if (m_Pending.isEmpty()) {
+        m_Mapping = QVector<quint32>();
+    }
+}
+/**
+* @brief 分片改写尚未按映射改写的倒排表
+* @param budgetMs 本次改写的时间预算(毫秒), 小于等于 0 表示不限制
+* @return 是否还有待改写的倒排表
+*/
+bool TrigramIndex::remapStep(int budgetMs) {
+    QElapsedTimer clock;
+    clock.start();
+    while (!m_Pending.isEmpty()) {
+        quint64 trigram = *m_Pending.constBegin();
+        auto entry = m_Postings.find(trigram);
+        if (entry == m_Postings.end()) {
+            m_Pending.remove(trigram);
+            continue;
+        }
+        settle(trigram, entry.value());
+        if (budgetMs > 0 && clock.elapsed() >= budgetMs) {
+            break;
+        }
+    }
+    if (m_Pending.isEmpty()) {
+        m_Mapping = QVector<quint32>();
+    }
+    return !m_Pending.isEmpty();
+}
+/**
+* @brief 是否还有待改写的倒排表
+*/
+bool TrigramIndex::remapPending() const {
+    return !m_Pending.isEmpty();
+}
+/**
+* @brief 通过倒排表求交集得到候选行
+* @param query 查询串
+* @param result 候选槽位号, 升序
+* @return 查询串能否使用索引; 少于 3 个字符时返回 false, 需逐行扫描
+*/
+bool TrigramIndex::candidates(const QString &query, QVector<quint32> &result) const {
+    result.clear();
+    QVector<quint64> trigrams;
+    appendTrigrams(query.toCaseFolded(), trigrams);
+    if (trigrams.isEmpty()) {
+        return false;
+    }
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+
+    // 任一三元组不存在即无结果; 否则从最短的倒排表开始求交集
+    QVector<const QVector<quint32>*> lists;
+    for (quint64 trigram : qAsConst(trigrams)) {
+        auto entry = m_Postings.find(trigram);
+        if (entry == m_Postings.end()) {
+            return true;
+        }
+        settle(trigram, entry.value());
+        lists.append(&entry.value());
+    }
+    std::sort(lists.begin(), lists.end(), [](const QVector<quint32> *a, const QVector<quint32> *b) {
+        return a->size() < b->size();
+    });
+
+    result = *lists.first();
+    for (int i = 1; i < lists.size() && !result.isEmpty(); i++) {
+        const QVector<quint32> &other = *lists.at(i);
+        // 候选集远小于倒排表时逐个二分查找, 否则线性归并
+        int write = 0;
+        if (result.size() * 16 < other.size()) {
+            for (quint32 slot : qAsConst(result)) {
+                if (std::binary_search(other.begin(), other.end(), slot)) {
+                    result[write++] = slot;
+                }
+            }
+        } else {
+            auto it = other.begin();
+            for (quint32 slot : qAsConst(result)) {
+                it = std::lower_bound(it, other.end(), slot);
+                if (it == other.end()) {
+                    break;
+                }
+                if (*it == slot) {
+                    result[write++] = slot;
+                }
+            }
+        }
+        result.resize(write);
+    }
+    return true;
+}
+/**
+* @brief 校验一行是否包含查询串, 忽略大小写
+* @param row 行数据
+* @param query 查询串
+*/
+bool TrigramIndex::matches(const QStringList &row, const QString &query) const {
+    if (m_Columns.isEmpty()) {
+        for (const QString &cell : row) {
+            if (cell.contains(query, Qt::CaseInsensitive)) {
+                return true;
+            }
+        }
+        return false;
+    }
+    for (int column : m_Columns) {
+        if (row.value(column).contains(query, Qt::CaseInsensitive)) {
+            return true;
+        }
+    }
+    return false;
+}
+/**
+* @brief 获取索引规模统计
+*/
+TrigramIndex::Stats TrigramIndex::stats() const {
+    Stats stats;
+    stats.trigrams = m_Postings.size();
+    stats.postings = m_PostingCount;
+    // 哈希节点按键、列表头和指针估算, 倒排表按已分配容量计算
+    stats.bytes = qint64(m_Postings.capacity()) * qint64(sizeof(void*));
+    for (auto it = m_Postings.constBegin(); it != m_Postings.constEnd(); ++it) {
+        stats.bytes += qint64(sizeof(quint64) + sizeof(QVector<quint32>) + 2 * sizeof(void*));
+        stats.bytes += qint64(it.value().capacity()) * qint64(sizeof(quint32));
+    }
+    return stats;
+}
+
+/**
+* @brief 倒排表尚未按映射改写时改写
+*/
+void TrigramIndex::settle(quint64 trigram, QVector<quint32> &list) const {
+    if (m_Pending.isEmpty() || !m_Pending.remove(trigram)) {
+        return;
+    }
+    for (quint32 &slot : list) {
+        slot = m_Mapping.at(int(slot));
+    }
+    if (m_Pending.isEmpty()) {
+        m_Mapping = QVector<quint32>();
+    }
+}
+/**
+* @brief 提取一行去重后的全部三元组
+*/
+QVector<quint64> TrigramIndex::rowTrigrams(const QStringList &row) const {
+    QVector<quint64> trigrams;
+    if (m_Columns.isEmpty()) {
+        for (const QString &cell : row) {
+            appendTrigrams(cell.toCaseFolded(), trigrams);
+        }
+    } else {
+        for (int column : m_Columns) {
+            appendTrigrams(row.value(column).toCaseFolded(), trigrams);
+        }
+    }
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    return trigrams;
+}
+/**
+* @brief 将文本的三元组追加到 out, 文本应已忽略大小写
+*/
+void TrigramIndex::appendTrigrams(const QString &folded, QVector<quint64> &out) {
+    const ushort *text = folded.utf16();
+    for (int i = 0; i + 2 < folded.size(); i++) {
+        out.append((quint64(text[i]) << 32) | (quint64(text[i + 1]) << 16) | quint64(text[i + 2]));
+    }
+}
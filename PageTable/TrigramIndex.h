@@ -0,0 +1,125 @@
+#ifndef TRIGRAMINDEX_H
+#define TRIGRAMINDEX_H
+
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include <QStringList>
+
+/**
+ * @author : LMH
+ * @date   : 2026.10.18
+ * @brief  : 三元组倒排索引, 用于子串搜索
+ *
+ * 每个单元格按忽略大小写后的连续 3 个字符切分, 每个三元组对应一张按槽位号升序的倒排表。
+ * 查询时取查询串的全部三元组, 从最短的倒排表开始求交集得到候选行, 再逐行校验是否真正包含查询串;
+ * 少于 3 个字符的查询无法用索引缩小范围, 由调用方逐行扫描。
+ * 行按槽位号登记, 追加时倒排表只在末尾写入, 修改和删除按二分查找定位。
+ * 槽位号的映射只做记录, 倒排表由 remapStep 分片改写, 改写完成前访问到的倒排表先行改写。
+ */
+class TrigramIndex {
+
+public:
+    /**
+     * @brief 索引规模统计
+     */
+    struct Stats {
+        int trigrams = 0;       // 不同三元组的数量
+        qint64 postings = 0;    // 倒排表条目总数
+        qint64 bytes = 0;       // 占用的内存(估算), 单位为字节
+    };
+
+    TrigramIndex();
+
+    /**
+     * @brief 设置参与索引和匹配的列, 为空表示全部列; 调用后应重新登记所有行
+     */
+    void setColumns(const QList<int> &columns);
+    /**
+     * @brief 清空索引, 保留列设置
+     */
+    void clear();
+    /**
+     * @brief 登记一行
+     * @param slot 行的槽位号
+     * @param row 行数据
+     */
+    void insert(quint32 slot, const QStringList &row);
+    /**
+     * @brief 移除一行, 行数据须与登记时一致
+     * @param slot 行的槽位号
+     * @param row 行数据
+     */
+    void remove(quint32 slot, const QStringList &row);
+    /**
+     * @brief 按映射改写槽位号, 映射须保持槽位号的先后顺序, 倒排表仍保持升序
+     * @param mapping 旧槽位号 -> 新槽位号
+     *
+     * 只登记映射, 倒排表由 remapStep 分片改写; 之后的登记、移除和查询照常使用新槽位号。
+     */
+    void remap(const QVector<quint32> &mapping);
+    /**
+     * @brief 分片改写尚未按映射改写的倒排表
+     * @param budgetMs 本次改写的时间预算(毫秒), 小于等于 0 表示不限制
+     * @return 是否还有待改写的倒排表
+     */
+    bool remapStep(int budgetMs);
+    /**
+     * @brief 是否还有待改写的倒排表
+     */
+    bool remapPending() const;
+    /**
+     * @brief 通过倒排表求交集得到候选行
+     * @param query 查询串
+     * @param result 候选槽位号, 升序
+     * @return 查询串能否使用索引; 少于 3 个字符时返回 false, 需逐行扫描
+     */
+    bool candidates(const QString &query, QVector<quint32> &result) const;
+    /**
+     * @brief 校验一行是否包含查询串, 忽略大小写
+     * @param row 行数据
+     * @param query 查询串
+     */
+    bool matches(const QStringList &row, const QString &query) const;
+    /**
+     * @brief 获取索引规模统计
+     */
+    Stats stats() const;
+
+private:
+    /**
+     * @brief 三元组 -> 升序的槽位号列表; 查询时也会改写访问到的待改写倒排表
+     */
+    mutable QHash<quint64, QVector<quint32>> m_Postings;
+    /**
+     * @brief 参与索引的列, 为空表示全部列
+     */
+    QList<int> m_Columns;
+    /**
+     * @brief 倒排表条目总数
+     */
+    qint64 m_PostingCount;
+    /**
+     * @brief 槽位号映射, 旧槽位号 -> 新槽位号; 仍有倒排表未改写时保留
+     */
+    mutable QVector<quint32> m_Mapping;
+    /**
+     * @brief 尚未按映射改写的三元组
+     */
+    mutable QSet<quint64> m_Pending;
+
+    /**
+     * @brief 倒排表尚未按映射改写时改写
+     */
+    void settle(quint64 trigram, QVector<quint32> &list) const;
+    /**
+     * @brief 提取一行去重后的全部三元组
+     */
+    QVector<quint64> rowTrigrams(const QStringList &row) const;
+    /**
+     * @brief 将文本的三元组追加到 out, 文本应已忽略大小写
+     */
+    static void appendTrigrams(const QString &folded, QVector<quint64> &out);
+};
+
+#endif // TRIGRAMINDEX_H
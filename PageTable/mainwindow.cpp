@@ -23,9 +23,14 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent) , ui(new Ui::MainW
 //    // 这里重新获取page是为了不影响下方定时器相关的代码
 //    page = static_cast<PageTable*>(pageLayout->itemAt(0)->widget());
 
+    // 接收本地生产者进程的数据, 可用 tools/FeedProducer 进行压力测试
+    if (!page->listenFeed("PageTableFeed")) {
+        qWarning() << "PageTableFeed 监听失败, 名称可能已被其他实例占用; 生产者数据将无法接入";
+    }
+
     /********************* 添加数据测试 ***********************/
-    // 定时器动态追加数据, 频率不要太快, 整组件级刷新而不是仅更新单元格文本, 将会影响按钮点击
-    m_timer.setInterval(1000);
+    // 定时器动态追加数据; 组件按帧合并刷新, 追加频率不会影响按钮点击
+    m_timer.setInterval(100);
     m_timer.setSingleShot(false);
     int timerCount = 0;// 定时器执行次数, 追加数据次数
     // 随机生成静态数据
@@ -42,9 +47,9 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent) , ui(new Ui::MainW
         page->updateData(m_data);
         m_data.clear();
 
-        // 追加10次
+        // 追加100次
         timerCount++;
-        if (timerCount >= 10) {
+        if (timerCount >= 100) {
             m_timer.stop();
             // 执行完追加后, 才允许进行修改操作
             changeTest();
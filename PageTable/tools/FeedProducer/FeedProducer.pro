@@ -0,0 +1,15 @@
+QT       += core network
+QT       -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+# 与组件共用帧格式
+INCLUDEPATH += ../..
+
+SOURCES += \
+    ../../FeedProtocol.cpp \
+    main.cpp
+
+HEADERS += \
+    ../../FeedProtocol.h
@@ -0,0 +1,100 @@
+#include <QTimer>
+#include <QDateTime>
+#include <QLocalSocket>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QCoreApplication>
+#include <QRandomGenerator>
+#include <QCommandLineParser>
+#include "FeedProtocol.h"
+
+/**
+ * @author : LMH
+ * @date   : 2026.10.18
+ * @brief  : 本地数据生产者, 按指定速率向分页组件的接入服务发送追加数据帧, 用于压力测试
+ *
+ * 用法: FeedProducer [--server PageTableFeed] [--rows 1000] [--rate 20] [--batches 0] [--columns 10]
+ */
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("PageTable feed load generator");
+    parser.addHelpOption();
+    parser.addOption({"server", "本地服务名", "name", "PageTableFeed"});
+    parser.addOption({"rows", "每帧行数", "count", "1000"});
+    parser.addOption({"rate", "每秒发送帧数", "count", "20"});
+    parser.addOption({"batches", "发送帧数, 0 表示不限", "count", "0"});
+    parser.addOption({"columns", "每行单元格数", "count", "10"});
+    parser.process(app);
+
+    const QString server = parser.value("server");
+    const int rows = qMax(1, parser.value("rows").toInt());
+    const int rate = qMax(1, parser.value("rate").toInt());
+    const int batches = qMax(0, parser.value("batches").toInt());
+    const int columns = qMax(1, parser.value("columns").toInt());
+
+    QLocalSocket socket;
+    socket.connectToServer(server);
+    if (!socket.waitForConnected(3000)) {
+        out << "无法连接到 " << server << ": " << socket.errorString() << '\n';
+        out.flush();
+        return 1;
+    }
+
+    // 少量状态值模拟低基数列, 其余为随机数
+    const QStringList statuses = {"正常", "告警", "故障", "离线"};
+    QRandomGenerator random(quint32(QDateTime::currentMSecsSinceEpoch()));
+    QElapsedTimer clock;
+    clock.start();
+    qint64 sentRows = 0;
+    qint64 sentBytes = 0;
+    int sentBatches = 0;
+
+    QTimer timer;
+    timer.setTimerType(Qt::PreciseTimer);
+    timer.setInterval(1000 / rate);
+    QObject::connect(&timer, &QTimer::timeout, &app, [&]() {
+        QList<QStringList> batch;
+        batch.reserve(rows);
+        for (int r = 0; r < rows; r++) {
+            QStringList row;
+            row << statuses.at(random.bounded(statuses.size()));
+            for (int c = 1; c < columns; c++) {
+                row << QString::number(random.generateDouble() * (2350.00 - 100.00) + 100.00, 'f', 2);
+            }
+            batch.append(row);
+        }
+
+        QByteArray frame;
+        FeedProtocol::encode(frame, 0, batch);
+        socket.write(frame);
+        sentRows += rows;
+        sentBytes += frame.size();
+        sentBatches++;
+
+        if (sentBatches % rate == 0) {
+            double seconds = clock.elapsed() / 1000.0;
+            out << QString("%1 行, %2 行/秒, %3 MB/秒")
+                   .arg(sentRows)
+                   .arg(sentRows / seconds, 0, 'f', 0)
+                   .arg(sentBytes / seconds / 1024 / 1024, 0, 'f', 2) << '\n';
+            out.flush();
+        }
+        if (batches > 0 && sentBatches >= batches) {
+            timer.stop();
+            socket.flush();
+            socket.waitForBytesWritten(3000);
+            app.quit();
+        }
+    });
+    QObject::connect(&socket, &QLocalSocket::disconnected, &app, [&]() {
+        out << "连接已断开" << '\n';
+        out.flush();
+        app.exit(1);
+    });
+
+    timer.start();
+    return app.exec();
+}